@@ -0,0 +1,54 @@
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "AggregatedIntervalMap.hpp"
+#include "BenchmarkSupport.hpp"
+#include "IntervalMap.hpp"
+
+namespace
+{
+	// Windows covering about a tenth of the boundaries
+	template <typename Aggregate>
+	void aggregateWindows(benchmark::State& state, Aggregate&& aggregate)
+	{
+		const std::int64_t keyRange = bench::makeKey<std::int64_t>(state.range(0));
+		std::uint64_t seed = 42;
+
+		for (auto _ : state)
+		{
+			seed = seed * 6364136223846793005u + 1442695040888963407u;
+			const std::int64_t lo = static_cast<std::int64_t>((seed >> 16) % static_cast<std::uint64_t>(keyRange));
+			benchmark::DoNotOptimize(aggregate(lo, lo + keyRange / 10));
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+}
+
+// Baseline: walk the pieces of the window
+static void BM_LinearWeightedSum(benchmark::State& state)
+{
+	const auto iMap = bench::makeMap<std::int64_t, std::int64_t, DS::FlatStorage>(state.range(0));
+
+	aggregateWindows(state, [&iMap](std::int64_t lo, std::int64_t hi)
+	{
+		std::int64_t sum = 0;
+		iMap.query(lo, hi, [&sum](const DS::IntervalView<std::int64_t, std::int64_t>& piece) { sum += piece.val * (piece.keyEnd - piece.keyBegin); });
+		return sum;
+	});
+}
+
+static void BM_AggregatedWeightedSum(benchmark::State& state)
+{
+	DS::AggregatedIntervalMap<std::int64_t, std::int64_t> iMap(0);
+	for (std::int64_t i = 0; i < state.range(0) / 2; ++i)
+	{
+		iMap.insert(bench::makeKey<std::int64_t>(2 * i), bench::makeKey<std::int64_t>(2 * i + 1), bench::makeValue<std::int64_t>(static_cast<std::size_t>(i)));
+	}
+
+	aggregateWindows(state, [&iMap](std::int64_t lo, std::int64_t hi) { return iMap.aggregate(lo, hi); });
+}
+
+BENCHMARK(BM_LinearWeightedSum)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+BENCHMARK(BM_AggregatedWeightedSum)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include "Interval.hpp"
+#include "IntervalMap.hpp"
+
+namespace bench
+{
+	// Map sizes in boundaries. Above 1e6 the maps need gigabytes, so bigger sizes are opt-in:
+	// INTERVAL_MAP_BENCH_MAX_BOUNDARIES=100000000 enables everything up to 1e8.
+	inline std::int64_t maxBoundaries()
+	{
+		const char* env = std::getenv("INTERVAL_MAP_BENCH_MAX_BOUNDARIES");
+		return env ? std::max<std::int64_t>(1000, std::atoll(env)) : 1000000;
+	}
+
+	// Float keys are spaced by 16 and stay exact below 2^24, which caps float maps at 1e6 boundaries
+	template <typename K>
+	void applySizes(benchmark::internal::Benchmark* bm)
+	{
+		const std::int64_t limit = std::is_floating_point_v<K> ? std::min<std::int64_t>(maxBoundaries(), 1000000) : maxBoundaries();
+		for (std::int64_t size = 1000; size <= limit; size *= 10)
+		{
+			bm->Arg(size);
+		}
+	}
+
+	// Distinct, never default values, so neighbouring intervals never merge
+	template <typename V>
+	V makeValue(std::size_t i)
+	{
+		const int seed = static_cast<int>(i % 1000) + 1;
+		if constexpr (std::is_same_v<V, std::string>)
+		{
+			return "interval-value-" + std::to_string(seed); // Longer than the small string buffer
+		}
+		else if constexpr (std::is_same_v<V, std::vector<int>>)
+		{
+			return std::vector<int>(4, seed);
+		}
+		else
+		{
+			return static_cast<V>(seed);
+		}
+	}
+
+	template <typename K>
+	K makeKey(std::int64_t i)
+	{
+		return static_cast<K>(i * 16);
+	}
+
+	// boundaries / 2 intervals [32 i, 32 i + 16) with gaps of valBegin in between, built in linear time
+	template <typename K, typename V, typename Storage>
+	DS::IntervalMap<K, V, Storage> makeMap(std::int64_t boundaries)
+	{
+		std::vector<DS::Interval<K, V>> intervals;
+		intervals.reserve(static_cast<std::size_t>(boundaries / 2));
+		for (std::int64_t i = 0; i < boundaries / 2; ++i)
+		{
+			intervals.push_back({ makeKey<K>(2 * i), makeKey<K>(2 * i + 1), makeValue<V>(static_cast<std::size_t>(i)) });
+		}
+
+		DS::IntervalMap<K, V, Storage> iMap(V{});
+		iMap.assignSorted(intervals.begin(), intervals.end());
+		return iMap;
+	}
+
+	// Largest resident set of the process so far. It never goes down, so read it per benchmark only as an upper bound.
+	inline double peakRssMegabytes()
+	{
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0.0;
+		return static_cast<double>(counters.PeakWorkingSetSize) / (1024.0 * 1024.0);
+#else
+		rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+#if defined(__APPLE__)
+		return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);
+#else
+		return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#endif
+#endif
+	}
+
+	// Times single operations outside the measured loop and reports percentiles as counters.
+	// Clock reads cost tens of nanoseconds, the percentiles include them.
+	template <typename Op>
+	void reportLatency(benchmark::State& state, std::size_t samples, Op&& op)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		std::vector<double> nanoseconds(samples);
+		for (std::size_t i = 0; i < samples; ++i)
+		{
+			const auto start = Clock::now();
+			op(i);
+			nanoseconds[i] = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+		}
+		std::sort(nanoseconds.begin(), nanoseconds.end());
+
+		auto percentile = [&](double p) { return nanoseconds[static_cast<std::size_t>(p * (samples - 1))]; };
+		state.counters["p50_ns"] = percentile(0.50);
+		state.counters["p90_ns"] = percentile(0.90);
+		state.counters["p99_ns"] = percentile(0.99);
+		state.counters["p999_ns"] = percentile(0.999);
+	}
+
+	inline void reportMemory(benchmark::State& state)
+	{
+		state.counters["peak_rss_MB"] = peakRssMegabytes();
+	}
+}
@@ -0,0 +1,84 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.hpp"
+#include "CachedLookup.hpp"
+#include "IntervalMap.hpp"
+
+namespace
+{
+	constexpr std::size_t kLookups = 4096;
+	constexpr std::int64_t kBoundaries = 1 << 20;
+
+	enum Pattern : std::int64_t
+	{
+		kLocal,   // Random walk of a few keys: mostly the same piece, sometimes a neighbour
+		kStrided, // Every 24th key: crosses one or two boundaries per lookup
+		kRandom   // Uniform over the map: every lookup is a full search
+	};
+
+	std::vector<int> makeKeys(Pattern pattern)
+	{
+		const std::int64_t keyRange = kBoundaries * 16;
+		std::mt19937_64 rng(7);
+
+		std::vector<int> keys(kLookups);
+		std::int64_t key = keyRange / 2;
+		for (auto& out : keys)
+		{
+			switch (pattern)
+			{
+				case kLocal: key += static_cast<std::int64_t>(rng() % 9) - 4; break;
+				case kStrided: key = (key + 24) % keyRange; break;
+				case kRandom: key = static_cast<std::int64_t>(rng() % keyRange); break;
+			}
+			out = static_cast<int>(key);
+		}
+		return keys;
+	}
+
+	// Each lookup depends on the previous one, as in the other lookup benchmarks
+	template <typename Lookup>
+	void chainedLookups(benchmark::State& state, Lookup&& lookup, const std::vector<int>& keys)
+	{
+		int carry = 0;
+		for (auto _ : state)
+		{
+			for (const int key : keys)
+			{
+				carry = lookup(key ^ (carry & 1));
+			}
+		}
+		benchmark::DoNotOptimize(carry);
+		state.SetItemsProcessed(state.iterations() * keys.size());
+	}
+
+	template <typename Storage>
+	void plainLookup(benchmark::State& state)
+	{
+		const auto iMap = bench::makeMap<int, int, Storage>(kBoundaries);
+		chainedLookups(state, [&iMap](int key) { return iMap[key]; }, makeKeys(static_cast<Pattern>(state.range(0))));
+	}
+
+	template <typename Storage>
+	void cachedLookup(benchmark::State& state)
+	{
+		const auto iMap = bench::makeMap<int, int, Storage>(kBoundaries);
+		auto lookup = DS::cachedLookup(iMap);
+		chainedLookups(state, [&lookup](int key) { return lookup[key]; }, makeKeys(static_cast<Pattern>(state.range(0))));
+		state.counters["hit_rate"] = static_cast<double>(lookup.hits()) / static_cast<double>(lookup.hits() + lookup.misses());
+	}
+}
+
+static void BM_PlainLookupTree(benchmark::State& state) { plainLookup<DS::TreeStorage>(state); }
+static void BM_CachedLookupTree(benchmark::State& state) { cachedLookup<DS::TreeStorage>(state); }
+static void BM_PlainLookupFlat(benchmark::State& state) { plainLookup<DS::FlatStorage>(state); }
+static void BM_CachedLookupFlat(benchmark::State& state) { cachedLookup<DS::FlatStorage>(state); }
+
+BENCHMARK(BM_PlainLookupTree)->ArgName("pattern")->DenseRange(kLocal, kRandom);
+BENCHMARK(BM_CachedLookupTree)->ArgName("pattern")->DenseRange(kLocal, kRandom);
+BENCHMARK(BM_PlainLookupFlat)->ArgName("pattern")->DenseRange(kLocal, kRandom);
+BENCHMARK(BM_CachedLookupFlat)->ArgName("pattern")->DenseRange(kLocal, kRandom);
@@ -0,0 +1,59 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.hpp"
+#include "CompressedIntervalMap.hpp"
+#include "IntervalMap.hpp"
+
+namespace
+{
+	constexpr std::size_t kLookups = 4096;
+
+	std::vector<int> makeLookupKeys(std::int64_t boundaries)
+	{
+		std::mt19937_64 rng(7);
+		std::uniform_int_distribution<std::int64_t> dist(0, boundaries * 16);
+
+		std::vector<int> keys(kLookups);
+		for (auto& key : keys)
+		{
+			key = static_cast<int>(dist(rng));
+		}
+		return keys;
+	}
+
+	// Dependent lookups, as in the static lookup benchmark: the time per lookup is its latency
+	template <typename Map>
+	void chainedLookups(benchmark::State& state, const Map& iMap, const std::vector<int>& keys)
+	{
+		int carry = 0;
+		for (auto _ : state)
+		{
+			for (const int key : keys)
+			{
+				carry = iMap[key ^ (carry & 1)];
+			}
+		}
+		benchmark::DoNotOptimize(carry);
+		state.SetItemsProcessed(state.iterations() * keys.size());
+	}
+}
+
+static void BM_TreeLookup(benchmark::State& state)
+{
+	const auto iMap = bench::makeMap<int, int, DS::TreeStorage>(state.range(0));
+	chainedLookups(state, iMap, makeLookupKeys(state.range(0)));
+}
+
+static void BM_CompressedLookup(benchmark::State& state)
+{
+	const auto compressed = DS::compress(bench::makeMap<int, int, DS::FlatStorage>(state.range(0)));
+	chainedLookups(state, compressed, makeLookupKeys(state.range(0)));
+	state.counters["bytes_per_boundary"] = static_cast<double>(compressed.memoryBytes()) / static_cast<double>(compressed.size());
+}
+
+BENCHMARK(BM_TreeLookup)->RangeMultiplier(16)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_CompressedLookup)->RangeMultiplier(16)->Range(1 << 10, 1 << 24);
@@ -0,0 +1,45 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "ConcurrentIntervalMap.hpp"
+
+namespace
+{
+	constexpr int kBoundaries = 1 << 16;
+
+	DS::ConcurrentIntervalMap<int, int>& sharedMap()
+	{
+		static DS::ConcurrentIntervalMap<int, int> iMap(0);
+		static const bool isFilled = []
+		{
+			for (int i = 0; i < kBoundaries / 2; ++i)
+			{
+				iMap.insert(i * 32, i * 32 + 16, i + 1);
+			}
+			iMap.publish();
+			return true;
+		}();
+
+		(void)isFilled;
+		return iMap;
+	}
+}
+
+// Read throughput per thread should stay flat as threads are added
+static void BM_ConcurrentRead(benchmark::State& state)
+{
+	const auto& iMap = sharedMap();
+
+	std::mt19937 rng(static_cast<unsigned>(state.thread_index()));
+	std::uniform_int_distribution<int> dist(0, kBoundaries * 16);
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(iMap[dist(rng)]);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ConcurrentRead)->ThreadRange(1, 32)->UseRealTime();
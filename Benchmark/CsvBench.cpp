@@ -0,0 +1,93 @@
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "CsvLoader.hpp"
+#include "IntervalMap.hpp"
+
+namespace
+{
+	constexpr int kLines = 1 << 21;
+
+	// About 20 bytes of "begin,end,value" per line
+	std::string writeCsv(const char* name, std::int64_t lines)
+	{
+		const std::string path = (std::filesystem::temp_directory_path() / name).string();
+		std::ofstream out(path, std::ios::binary);
+		std::uint32_t seed = 42;
+		for (std::int64_t i = 0; i < lines; ++i)
+		{
+			seed = seed * 1103515245u + 12345u;
+			const std::uint32_t keyBegin = (seed >> 4) % 100000000u;
+			out << keyBegin << ',' << keyBegin + 1 + (seed % 5000) << ',' << (seed >> 28) << '\n';
+		}
+		return path;
+	}
+
+	// About 40 MB, written once per process
+	const std::string& csvPath()
+	{
+		static const std::string path = writeCsv("interval_map_bench.csv", kLines);
+		return path;
+	}
+}
+
+// Baseline: iostream parsing and one insert() per line
+static void BM_CsvIostreamInsert(benchmark::State& state)
+{
+	for (auto _ : state)
+	{
+		DS::IntervalMap<std::int64_t, int, DS::TreeStorage> iMap(0);
+		std::ifstream in(csvPath());
+		std::string line;
+		while (std::getline(in, line))
+		{
+			std::istringstream fields(line);
+			std::int64_t keyBegin, keyEnd;
+			int val;
+			char comma;
+			fields >> keyBegin >> comma >> keyEnd >> comma >> val;
+			iMap.insert(keyBegin, keyEnd, val);
+		}
+		benchmark::DoNotOptimize(&iMap);
+	}
+	state.SetItemsProcessed(state.iterations() * kLines);
+}
+
+static void BM_CsvLoad(benchmark::State& state)
+{
+	DS::CsvOptions options;
+	options.threadCount = static_cast<std::size_t>(state.range(0));
+
+	for (auto _ : state)
+	{
+		DS::IntervalMap<std::int64_t, int, DS::TreeStorage> iMap(0);
+		benchmark::DoNotOptimize(DS::loadCsv(iMap, csvPath(), options));
+	}
+	state.SetItemsProcessed(state.iterations() * kLines);
+}
+
+// Growing files in small chunks on a contiguous storage: time per line has to stay flat, not grow with the file
+static void BM_CsvLoadFlat(benchmark::State& state)
+{
+	const std::string path = writeCsv("interval_map_bench_flat.csv", state.range(0));
+	DS::CsvOptions options;
+	options.chunkBytes = 64 << 10;
+
+	for (auto _ : state)
+	{
+		DS::IntervalMap<std::int64_t, int, DS::FlatStorage> iMap(0);
+		benchmark::DoNotOptimize(DS::loadCsv(iMap, path, options));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_CsvIostreamInsert)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_CsvLoad)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_CsvLoadFlat)->RangeMultiplier(4)->Range(1 << 14, 1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,65 @@
+#include <cstdint>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.hpp"
+#include "IntervalMap.hpp"
+
+namespace
+{
+	constexpr int kUpdates = 64;
+
+	using Map = DS::IntervalMap<int, int, DS::TreeStorage>;
+	using Journal = DS::DeltaLog<int, int>;
+
+	// A batch of short updates on the primary, outside of the measured time
+	void updatePrimary(benchmark::State& state, Map& primary, std::mt19937& rng)
+	{
+		state.PauseTiming();
+		std::uniform_int_distribution<int> dist(0, static_cast<int>(state.range(0)) * 16);
+		for (int i = 0; i < kUpdates; ++i)
+		{
+			const int keyBegin = dist(rng);
+			primary.insert(keyBegin, keyBegin + 40, i % 5 + 1);
+		}
+		state.ResumeTiming();
+	}
+}
+
+// Today's replication: every replica receives the whole map after each batch
+static void BM_ReplicateFullCopy(benchmark::State& state)
+{
+	Map primary = bench::makeMap<int, int, DS::TreeStorage>(state.range(0));
+	Map replica = primary;
+	std::mt19937 rng(7);
+
+	for (auto _ : state)
+	{
+		updatePrimary(state, primary, rng);
+		replica = primary;
+	}
+	state.counters["bytes_per_batch"] = static_cast<double>(primary.getMap().size() * (sizeof(int) + sizeof(int)));
+}
+
+static void BM_ReplicateDelta(benchmark::State& state)
+{
+	Map primary = bench::makeMap<int, int, DS::TreeStorage>(state.range(0));
+	Map replica = primary;
+	Journal journal;
+	primary.attachJournal(&journal);
+	std::mt19937 rng(7);
+
+	std::size_t shipped = 0;
+	for (auto _ : state)
+	{
+		updatePrimary(state, primary, rng);
+		replica.applyDelta(journal);
+		shipped += journal.ops().size_bytes() + journal.values().size_bytes() + journal.eraseLasts().size_bytes();
+		journal.clear();
+	}
+	state.counters["bytes_per_batch"] = static_cast<double>(shipped) / static_cast<double>(state.iterations());
+}
+
+BENCHMARK(BM_ReplicateFullCopy)->RangeMultiplier(16)->Range(1 << 12, 1 << 20);
+BENCHMARK(BM_ReplicateDelta)->RangeMultiplier(16)->Range(1 << 12, 1 << 20);
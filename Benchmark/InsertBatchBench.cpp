@@ -0,0 +1,86 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "IntervalMap.hpp"
+
+namespace
+{
+	constexpr int kKeyRange = 1 << 20;
+	constexpr int kBaseIntervals = 1 << 16;
+
+	// Overlap density is driven by the mean interval length relative to the gap between interval starts
+	std::vector<DS::Interval<int, int>> makeBatch(size_t count, int maxLength, unsigned seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> begin(0, kKeyRange);
+		std::uniform_int_distribution<int> length(1, maxLength);
+		std::uniform_int_distribution<int> val(0, 15);
+
+		std::vector<DS::Interval<int, int>> batch(count);
+		for (auto& interval : batch)
+		{
+			interval.keyBegin = begin(rng);
+			interval.keyEnd = interval.keyBegin + length(rng);
+			interval.val = val(rng);
+		}
+		return batch;
+	}
+
+	template <typename Storage>
+	DS::IntervalMap<int, int, Storage> makeBaseMap()
+	{
+		const auto intervals = makeBatch(kBaseIntervals, 16, 1);
+		DS::IntervalMap<int, int, Storage> iMap(0);
+		iMap.assign(intervals.begin(), intervals.end());
+		return iMap;
+	}
+}
+
+// range(0): batch size, range(1): maximum interval length
+template <typename Storage>
+static void BM_InsertSequential(benchmark::State& state)
+{
+	const auto base = makeBaseMap<Storage>();
+	const auto batch = makeBatch(static_cast<size_t>(state.range(0)), static_cast<int>(state.range(1)), 2);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		auto iMap = base;
+		state.ResumeTiming();
+
+		for (const auto& interval : batch)
+		{
+			iMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		}
+		benchmark::DoNotOptimize(iMap.getMap().size());
+	}
+	state.SetItemsProcessed(state.iterations() * batch.size());
+}
+
+template <typename Storage>
+static void BM_InsertBatch(benchmark::State& state)
+{
+	const auto base = makeBaseMap<Storage>();
+	const auto batch = makeBatch(static_cast<size_t>(state.range(0)), static_cast<int>(state.range(1)), 2);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		auto iMap = base;
+		state.ResumeTiming();
+
+		iMap.insertBatch(batch);
+		benchmark::DoNotOptimize(iMap.getMap().size());
+	}
+	state.SetItemsProcessed(state.iterations() * batch.size());
+}
+
+#define INSERT_BATCH_ARGS ArgsProduct({ { 100, 1000, 10000, 100000 }, { 16, 1024, 65536 } })->Unit(benchmark::kMicrosecond)
+
+BENCHMARK_TEMPLATE(BM_InsertSequential, DS::TreeStorage)->INSERT_BATCH_ARGS;
+BENCHMARK_TEMPLATE(BM_InsertBatch, DS::TreeStorage)->INSERT_BATCH_ARGS;
+BENCHMARK_TEMPLATE(BM_InsertSequential, DS::FlatStorage)->ArgsProduct({ { 100, 1000 }, { 16, 1024, 65536 } })->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_InsertBatch, DS::FlatStorage)->INSERT_BATCH_ARGS;
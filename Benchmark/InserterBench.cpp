@@ -0,0 +1,86 @@
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.hpp"
+#include "IntervalMap.hpp"
+
+namespace
+{
+	constexpr int kAppends = 1 << 16;
+}
+
+// Time-series ingestion: every interval starts where the previous one ended
+template <typename Storage>
+static void BM_AppendInsert(benchmark::State& state)
+{
+	for (auto _ : state)
+	{
+		DS::IntervalMap<int, int, Storage> iMap(0);
+		for (int i = 0; i < kAppends; ++i)
+		{
+			iMap.insert(i * 4, i * 4 + 4, i % 3 + 1);
+		}
+		benchmark::DoNotOptimize(&iMap);
+	}
+	state.SetItemsProcessed(state.iterations() * kAppends);
+}
+
+template <typename Storage>
+static void BM_AppendInserter(benchmark::State& state)
+{
+	for (auto _ : state)
+	{
+		DS::IntervalMap<int, int, Storage> iMap(0);
+		auto inserter = iMap.inserter();
+		for (int i = 0; i < kAppends; ++i)
+		{
+			inserter.insert(i * 4, i * 4 + 4, i % 3 + 1);
+		}
+		benchmark::DoNotOptimize(&iMap);
+	}
+	state.SetItemsProcessed(state.iterations() * kAppends);
+}
+
+// Updates wandering around the middle of a large map
+template <typename Storage>
+static void BM_LocalizedInserter(benchmark::State& state)
+{
+	auto iMap = bench::makeMap<int, int, Storage>(state.range(0));
+	auto inserter = iMap.inserter();
+	int key = static_cast<int>(bench::makeKey<int>(state.range(0) / 2));
+	std::uint32_t seed = 1;
+
+	for (auto _ : state)
+	{
+		seed = seed * 1103515245u + 12345u;
+		key += static_cast<int>((seed >> 16) % 65) - 32;
+		inserter.insert(key, key + 8, static_cast<int>(seed >> 28) + 1);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Storage>
+static void BM_LocalizedInsert(benchmark::State& state)
+{
+	auto iMap = bench::makeMap<int, int, Storage>(state.range(0));
+	int key = static_cast<int>(bench::makeKey<int>(state.range(0) / 2));
+	std::uint32_t seed = 1;
+
+	for (auto _ : state)
+	{
+		seed = seed * 1103515245u + 12345u;
+		key += static_cast<int>((seed >> 16) % 65) - 32;
+		iMap.insert(key, key + 8, static_cast<int>(seed >> 28) + 1);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_AppendInsert, DS::TreeStorage);
+BENCHMARK_TEMPLATE(BM_AppendInsert, DS::FlatStorage);
+BENCHMARK_TEMPLATE(BM_AppendInserter, DS::TreeStorage);
+BENCHMARK_TEMPLATE(BM_AppendInserter, DS::FlatStorage);
+BENCHMARK_TEMPLATE(BM_LocalizedInsert, DS::TreeStorage)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_LocalizedInsert, DS::FlatStorage)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_LocalizedInserter, DS::TreeStorage)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_LocalizedInserter, DS::FlatStorage)->Arg(1 << 20);
@@ -0,0 +1,98 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.hpp"
+#include "InternedIntervalMap.hpp"
+#include "IntervalMap.hpp"
+
+namespace
+{
+	constexpr std::size_t kInserts = 1 << 14;
+	constexpr std::size_t kDistinctBlobs = 16;
+
+	// 1 KiB configuration blobs, few of them shared by every interval
+	std::vector<std::string> makeBlobs()
+	{
+		std::vector<std::string> blobs;
+		for (std::size_t i = 0; i < kDistinctBlobs; ++i)
+		{
+			blobs.push_back(std::string(1024, static_cast<char>('a' + i)));
+		}
+		return blobs;
+	}
+
+	// Same generator as the tests, kept local so the benchmark has no gtest dependency
+	std::vector<DS::Interval<int, int>> makeRandomIntervals(std::size_t count, int keyRange, int maxLength, std::size_t valRange)
+	{
+		std::mt19937 rng(42);
+		std::vector<DS::Interval<int, int>> intervals;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const int keyBegin = static_cast<int>(rng() % keyRange);
+			intervals.push_back({ keyBegin, keyBegin + 1 + static_cast<int>(rng() % maxLength), static_cast<int>(rng() % valRange) });
+		}
+		return intervals;
+	}
+
+	template <typename Map>
+	void insertBlobs(benchmark::State& state)
+	{
+		const auto blobs = makeBlobs();
+		const auto intervals = makeRandomIntervals(kInserts, static_cast<int>(state.range(0)), 64, kDistinctBlobs);
+
+		for (auto _ : state)
+		{
+			Map iMap;
+			for (const auto& interval : intervals)
+			{
+				iMap.insert(interval.keyBegin, interval.keyEnd, blobs[interval.val]);
+			}
+			benchmark::DoNotOptimize(&iMap);
+		}
+		state.SetItemsProcessed(state.iterations() * intervals.size());
+		bench::reportMemory(state);
+	}
+}
+
+static void BM_InsertBlobPlain(benchmark::State& state)
+{
+	insertBlobs<DS::IntervalMap<int, std::string>>(state);
+}
+
+static void BM_InsertBlobInterned(benchmark::State& state)
+{
+	insertBlobs<DS::InternedIntervalMap<int, std::string>>(state);
+}
+
+// Values interned once up front, inserts touch integers only
+static void BM_InsertBlobInternedIds(benchmark::State& state)
+{
+	const auto blobs = makeBlobs();
+	const auto intervals = makeRandomIntervals(kInserts, static_cast<int>(state.range(0)), 64, kDistinctBlobs);
+
+	for (auto _ : state)
+	{
+		DS::InternedIntervalMap<int, std::string> iMap;
+		std::vector<std::uint32_t> ids;
+		for (const auto& blob : blobs)
+		{
+			ids.push_back(iMap.intern(blob));
+		}
+		for (const auto& interval : intervals)
+		{
+			iMap.insertId(interval.keyBegin, interval.keyEnd, ids[interval.val]);
+		}
+		benchmark::DoNotOptimize(&iMap);
+	}
+	state.SetItemsProcessed(state.iterations() * intervals.size());
+	bench::reportMemory(state);
+}
+
+BENCHMARK(BM_InsertBlobPlain)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK(BM_InsertBlobInterned)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK(BM_InsertBlobInternedIds)->Arg(1 << 12)->Arg(1 << 16);
@@ -0,0 +1,104 @@
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.hpp"
+#include "IntervalMap.hpp"
+#include "LazyIntervalMap.hpp"
+
+namespace
+{
+	constexpr std::int64_t kBoundaries = 1 << 16;
+	constexpr std::size_t kUpdates = 1 << 8;
+
+	// Wide increments, each one covering a random quarter of the map
+	std::vector<DS::Interval<int, int>> makeUpdates()
+	{
+		std::uint32_t seed = 42;
+		const int keyRange = bench::makeKey<int>(kBoundaries);
+
+		std::vector<DS::Interval<int, int>> updates;
+		for (std::size_t i = 0; i < kUpdates; ++i)
+		{
+			seed = seed * 1103515245u + 12345u;
+			const int keyBegin = static_cast<int>((seed >> 8) % (keyRange - keyRange / 4));
+			updates.push_back({ keyBegin, keyBegin + keyRange / 4, 1 });
+		}
+		return updates;
+	}
+}
+
+// Read the pieces out, insert them back incremented
+static void BM_EagerRangeIncrement(benchmark::State& state)
+{
+	const auto base = bench::makeMap<int, int, DS::TreeStorage>(kBoundaries);
+	const auto updates = makeUpdates();
+
+	for (auto _ : state)
+	{
+		auto iMap = base;
+		std::vector<DS::Interval<int, int>> pieces;
+		for (const auto& update : updates)
+		{
+			pieces.clear();
+			iMap.query(update.keyBegin, update.keyEnd, [&pieces](const DS::IntervalView<int, int>& piece) { pieces.push_back({ piece.keyBegin, piece.keyEnd, piece.val }); });
+			for (const auto& piece : pieces)
+			{
+				iMap.insert(piece.keyBegin, piece.keyEnd, piece.val + update.val);
+			}
+		}
+		benchmark::DoNotOptimize(&iMap);
+	}
+	state.SetItemsProcessed(state.iterations() * updates.size());
+}
+
+static void BM_LazyRangeIncrement(benchmark::State& state)
+{
+	const auto base = bench::makeMap<int, int, DS::TreeStorage>(kBoundaries);
+	const auto updates = makeUpdates();
+
+	for (auto _ : state)
+	{
+		DS::LazyIntervalMap<int, int, DS::TreeStorage> iMap(0);
+		for (const auto& interval : base.intervals())
+		{
+			iMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		}
+		for (const auto& update : updates)
+		{
+			iMap.transform(update.keyBegin, update.keyEnd, [increment = update.val](int val) { return val + increment; });
+		}
+		benchmark::DoNotOptimize(iMap.materialize());
+	}
+	state.SetItemsProcessed(state.iterations() * updates.size());
+}
+
+// Updates interleaved with point reads, nothing is ever iterated
+static void BM_LazyRangeIncrementAndLookup(benchmark::State& state)
+{
+	const auto base = bench::makeMap<int, int, DS::TreeStorage>(kBoundaries);
+	const auto updates = makeUpdates();
+
+	DS::LazyIntervalMap<int, int, DS::TreeStorage> iMap(0);
+	for (const auto& interval : base.intervals())
+	{
+		iMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+	}
+
+	int sum = 0;
+	for (auto _ : state)
+	{
+		for (const auto& update : updates)
+		{
+			iMap.transform(update.keyBegin, update.keyEnd, [increment = update.val](int val) { return val + increment; });
+			sum += iMap[update.keyEnd - 1];
+		}
+	}
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(state.iterations() * updates.size());
+}
+
+BENCHMARK(BM_EagerRangeIncrement)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LazyRangeIncrement)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LazyRangeIncrementAndLookup)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "IntervalMap.hpp"
+
+namespace
+{
+	constexpr size_t kKeysPerIteration = 4096;
+
+	// Map of `boundaries` boundaries spread over [0, boundaries * 16) with alternating values
+	template <typename Storage>
+	DS::IntervalMap<int, int, Storage> makeMap(int boundaries)
+	{
+		DS::IntervalMap<int, int, Storage> iMap(0);
+		for (int i = 0; i < boundaries / 2; ++i)
+		{
+			iMap.insert(i * 32, i * 32 + 16, i + 1);
+		}
+		return iMap;
+	}
+
+	std::vector<int> makeKeys(int boundaries, bool sorted)
+	{
+		std::mt19937 rng(12345);
+		std::uniform_int_distribution<int> dist(-16, boundaries * 16 + 16);
+
+		std::vector<int> keys(kKeysPerIteration);
+		std::generate(keys.begin(), keys.end(), [&] { return dist(rng); });
+		if (sorted)
+		{
+			std::sort(keys.begin(), keys.end());
+		}
+		return keys;
+	}
+}
+
+template <typename Storage>
+static void BM_PointLookup(benchmark::State& state)
+{
+	const auto iMap = makeMap<Storage>(static_cast<int>(state.range(0)));
+	const auto keys = makeKeys(static_cast<int>(state.range(0)), false);
+	std::vector<int> out(keys.size());
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			out[i] = iMap[keys[i]];
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Storage>
+static void BM_LookupBatch(benchmark::State& state)
+{
+	const auto iMap = makeMap<Storage>(static_cast<int>(state.range(0)));
+	const auto keys = makeKeys(static_cast<int>(state.range(0)), false);
+	std::vector<int> out(keys.size());
+
+	for (auto _ : state)
+	{
+		iMap.lookupBatch(keys.data(), keys.size(), out.data());
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Storage>
+static void BM_LookupBatchSorted(benchmark::State& state)
+{
+	const auto iMap = makeMap<Storage>(static_cast<int>(state.range(0)));
+	const auto keys = makeKeys(static_cast<int>(state.range(0)), true);
+	std::vector<int> out(keys.size());
+
+	for (auto _ : state)
+	{
+		iMap.lookupBatchSorted(keys.data(), keys.size(), out.data());
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK_TEMPLATE(BM_PointLookup, DS::TreeStorage)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_PointLookup, DS::FlatStorage)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_LookupBatch, DS::TreeStorage)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_LookupBatch, DS::FlatStorage)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_LookupBatchSorted, DS::FlatStorage)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,103 @@
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "IntervalMap.hpp"
+#include "PersistentIntervalMap.hpp"
+
+namespace
+{
+	std::size_t g_allocatedBytes = 0;
+
+	// Counts the bytes handed out for tree nodes, nothing is subtracted on deallocation
+	template <typename T>
+	struct CountingAllocator
+	{
+		using value_type = T;
+
+		CountingAllocator() = default;
+
+		template <typename U>
+		CountingAllocator(const CountingAllocator<U>&) {}
+
+		T* allocate(std::size_t n)
+		{
+			g_allocatedBytes += n * sizeof(T);
+			return std::allocator<T>().allocate(n);
+		}
+
+		void deallocate(T* ptr, std::size_t n)
+		{
+			std::allocator<T>().deallocate(ptr, n);
+		}
+
+		friend bool operator==(const CountingAllocator&, const CountingAllocator&) { return true; }
+	};
+
+	template <typename Map>
+	void fill(Map& iMap, int boundaries)
+	{
+		for (int i = 0; i < boundaries / 2; ++i)
+		{
+			iMap.insert(i * 32, i * 32 + 16, i + 1);
+		}
+	}
+}
+
+// O(1) whatever the size
+static void BM_PersistentSnapshot(benchmark::State& state)
+{
+	DS::PersistentIntervalMap<int, int> iMap(0);
+	fill(iMap, static_cast<int>(state.range(0)));
+
+	for (auto _ : state)
+	{
+		auto version = iMap.snapshot();
+		benchmark::DoNotOptimize(version);
+	}
+}
+
+// Baseline: a version of the mutable map is a full copy
+static void BM_IntervalMapCopy(benchmark::State& state)
+{
+	DS::IntervalMap<int, int> iMap(0);
+	fill(iMap, static_cast<int>(state.range(0)));
+
+	for (auto _ : state)
+	{
+		auto version = iMap;
+		benchmark::DoNotOptimize(version);
+	}
+}
+
+// Each version is one snapshot followed by one insertion, every version is kept alive
+static void BM_PersistentVersionMemory(benchmark::State& state)
+{
+	using Map = DS::PersistentIntervalMap<int, int, CountingAllocator<std::pair<const int, int>>>;
+
+	const int boundaries = static_cast<int>(state.range(0));
+	Map iMap(0);
+	fill(iMap, boundaries);
+
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<int> begin(0, boundaries * 16);
+
+	std::vector<Map> versions;
+	const std::size_t bytesBefore = g_allocatedBytes;
+	for (auto _ : state)
+	{
+		versions.push_back(iMap.snapshot());
+		const int keyBegin = begin(rng);
+		iMap.insert(keyBegin, keyBegin + 24, keyBegin);
+	}
+
+	state.counters["bytes_per_version"] = static_cast<double>(g_allocatedBytes - bytesBefore) / static_cast<double>(state.iterations());
+	state.counters["full_copy_bytes"] = static_cast<double>(iMap.size() * (sizeof(int) * 2 + 4 * sizeof(void*)));
+}
+
+BENCHMARK(BM_PersistentSnapshot)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_IntervalMapCopy)->RangeMultiplier(16)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PersistentVersionMemory)->RangeMultiplier(16)->Range(1 << 10, 1 << 20)->Iterations(10000);
@@ -0,0 +1,66 @@
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "IntervalMap.hpp"
+#include "ShardedIntervalMap.hpp"
+
+namespace
+{
+	constexpr int kMaxThreads = 64;
+	constexpr int kRangePerThread = 1 << 20;
+
+	std::vector<int> makeSplitKeys()
+	{
+		std::vector<int> splitKeys;
+		for (int t = 1; t < kMaxThreads; ++t)
+		{
+			splitKeys.push_back(t * kRangePerThread);
+		}
+		return splitKeys;
+	}
+
+	// Writer t stays inside [t * kRangePerThread, (t + 1) * kRangePerThread)
+	template <typename Insert>
+	void writeOwnRange(benchmark::State& state, Insert&& insert)
+	{
+		const int base = state.thread_index() * kRangePerThread;
+		std::uint32_t seed = static_cast<std::uint32_t>(state.thread_index()) + 1;
+
+		for (auto _ : state)
+		{
+			seed = seed * 1103515245u + 12345u;
+			const int keyBegin = base + static_cast<int>((seed >> 8) % (kRangePerThread - 64));
+			insert(keyBegin, keyBegin + 1 + static_cast<int>(seed % 63), static_cast<int>(seed >> 29));
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+}
+
+// Baseline: one map, one mutex
+static void BM_SingleLockInsert(benchmark::State& state)
+{
+	static std::mutex mutex;
+	static DS::IntervalMap<int, int> iMap(0);
+
+	writeOwnRange(state, [](int keyBegin, int keyEnd, int val)
+	{
+		std::lock_guard lock(mutex);
+		iMap.insert(keyBegin, keyEnd, val);
+	});
+}
+
+static void BM_ShardedInsert(benchmark::State& state)
+{
+	static DS::ShardedIntervalMap<int, int> iMap(makeSplitKeys(), 0);
+
+	writeOwnRange(state, [](int keyBegin, int keyEnd, int val)
+	{
+		iMap.insert(keyBegin, keyEnd, val);
+	});
+}
+
+BENCHMARK(BM_SingleLockInsert)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_ShardedInsert)->ThreadRange(1, 16)->UseRealTime();
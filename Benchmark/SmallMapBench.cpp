@@ -0,0 +1,42 @@
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include "IntervalMap.hpp"
+
+namespace
+{
+	// Per-request maps: built, queried a few times, dropped
+	template <typename Map>
+	void buildAndQuery(benchmark::State& state)
+	{
+		const int intervals = static_cast<int>(state.range(0));
+		std::uint32_t seed = 42;
+
+		for (auto _ : state)
+		{
+			Map iMap(0);
+			for (int i = 0; i < intervals; ++i)
+			{
+				iMap.insert(16 * i, 16 * i + 8, i + 1);
+			}
+
+			int sum = 0;
+			for (int i = 0; i < 8; ++i)
+			{
+				seed = seed * 1103515245u + 12345u;
+				sum += iMap[static_cast<int>((seed >> 16) % (16 * intervals))];
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+}
+
+static void BM_SmallTree(benchmark::State& state) { buildAndQuery<DS::IntervalMap<int, int, DS::TreeStorage>>(state); }
+static void BM_SmallFlat(benchmark::State& state) { buildAndQuery<DS::IntervalMap<int, int, DS::FlatStorage>>(state); }
+static void BM_SmallInline(benchmark::State& state) { buildAndQuery<DS::SmallIntervalMap<int, int, 32>>(state); }
+
+BENCHMARK(BM_SmallTree)->Arg(4)->Arg(16);
+BENCHMARK(BM_SmallFlat)->Arg(4)->Arg(16);
+BENCHMARK(BM_SmallInline)->Arg(4)->Arg(16);
@@ -0,0 +1,63 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.hpp"
+#include "IntervalMap.hpp"
+#include "StaticIntervalMap.hpp"
+
+namespace
+{
+	constexpr std::size_t kLookups = 4096;
+
+	std::vector<int> makeLookupKeys(std::int64_t boundaries)
+	{
+		std::mt19937_64 rng(7);
+		std::uniform_int_distribution<std::int64_t> dist(0, boundaries * 16);
+
+		std::vector<int> keys(kLookups);
+		for (auto& key : keys)
+		{
+			key = static_cast<int>(dist(rng));
+		}
+		return keys;
+	}
+
+	// Dependent lookups: each key depends on the previous answer, so the time per lookup is its latency
+	template <typename Map>
+	void chainedLookups(benchmark::State& state, const Map& iMap, const std::vector<int>& keys)
+	{
+		int carry = 0;
+		for (auto _ : state)
+		{
+			for (const int key : keys)
+			{
+				carry = iMap[key ^ (carry & 1)];
+			}
+		}
+		benchmark::DoNotOptimize(carry);
+		state.SetItemsProcessed(state.iterations() * keys.size());
+	}
+}
+
+template <typename Storage>
+static void BM_DynamicLookupLatency(benchmark::State& state)
+{
+	const auto iMap = bench::makeMap<int, int, Storage>(state.range(0));
+	chainedLookups(state, iMap, makeLookupKeys(state.range(0)));
+	bench::reportMemory(state);
+}
+
+static void BM_FrozenLookupLatency(benchmark::State& state)
+{
+	const auto frozen = DS::freeze(bench::makeMap<int, int, DS::FlatStorage>(state.range(0)));
+	chainedLookups(state, frozen, makeLookupKeys(state.range(0)));
+	bench::reportMemory(state);
+}
+
+// Up to 1 << 24 boundaries (64 MiB of keys): larger than the L3 of most machines
+BENCHMARK_TEMPLATE(BM_DynamicLookupLatency, DS::TreeStorage)->RangeMultiplier(16)->Range(1 << 10, 1 << 24);
+BENCHMARK_TEMPLATE(BM_DynamicLookupLatency, DS::FlatStorage)->RangeMultiplier(16)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_FrozenLookupLatency)->RangeMultiplier(16)->Range(1 << 10, 1 << 24);
@@ -0,0 +1,40 @@
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "IntervalMap.hpp"
+
+namespace
+{
+	template <typename Stats>
+	using Map = DS::IntervalMap<int, int, DS::TreeStorage, std::allocator<std::pair<const int, int>>, Stats>;
+
+	// Overhead of the hooks on the hot paths, counters and the sampled clock reads included
+	template <typename Stats>
+	void insertAndLookup(benchmark::State& state)
+	{
+		Map<Stats> iMap(0);
+		for (int i = 0; i < 1 << 14; ++i)
+		{
+			iMap.insert(16 * i, 16 * i + 8, i & 7);
+		}
+
+		std::uint32_t seed = 42;
+		for (auto _ : state)
+		{
+			seed = seed * 1103515245u + 12345u;
+			const int key = static_cast<int>((seed >> 8) % (16 << 14));
+			iMap.insert(key, key + 4, static_cast<int>(seed >> 29));
+			benchmark::DoNotOptimize(iMap[key ^ 0x55]);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+}
+
+static void BM_NoStats(benchmark::State& state) { insertAndLookup<DS::NoStats>(state); }
+static void BM_CountingStats(benchmark::State& state) { insertAndLookup<DS::CountingStats<>>(state); }
+
+BENCHMARK(BM_NoStats);
+BENCHMARK(BM_CountingStats);
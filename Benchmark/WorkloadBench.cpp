@@ -0,0 +1,226 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.hpp"
+#include "IntervalMap.hpp"
+
+// Reference workloads over map sizes and K/V types. Run with
+//   --benchmark_out=results.json --benchmark_out_format=json
+// for machine-readable results. Every benchmark also reports latency percentiles and the peak RSS.
+
+namespace
+{
+	constexpr std::size_t kOpsPerIteration = 1024;
+	constexpr std::size_t kLatencySamples = 20000;
+
+	template <typename K>
+	std::vector<K> makeRandomKeys(std::int64_t boundaries, std::size_t count, unsigned seed)
+	{
+		std::mt19937_64 rng(seed);
+		std::uniform_int_distribution<std::int64_t> dist(-1, boundaries + 1);
+
+		std::vector<K> keys(count);
+		for (auto& key : keys)
+		{
+			key = bench::makeKey<K>(dist(rng)) + static_cast<K>(3); // Inside an interval or a gap, off the boundaries
+		}
+		return keys;
+	}
+
+	// Mutating workloads change the map size, it is rebuilt (untimed) once it drifted by 2x
+	template <typename Map>
+	void keepSize(benchmark::State& state, Map& iMap, const Map& initial)
+	{
+		const std::size_t size = iMap.getMap().size();
+		const std::size_t target = initial.getMap().size();
+		if (2 * size < target || size > 2 * target + 2)
+		{
+			state.PauseTiming();
+			iMap = initial;
+			state.ResumeTiming();
+		}
+	}
+}
+
+template <typename K, typename V, typename Storage>
+static void BM_RandomLookup(benchmark::State& state)
+{
+	const auto iMap = bench::makeMap<K, V, Storage>(state.range(0));
+	const auto keys = makeRandomKeys<K>(state.range(0), kOpsPerIteration, 1);
+
+	for (auto _ : state)
+	{
+		for (const K& key : keys)
+		{
+			benchmark::DoNotOptimize(&iMap[key]);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * keys.size());
+
+	const auto samples = makeRandomKeys<K>(state.range(0), kLatencySamples, 2);
+	bench::reportLatency(state, kLatencySamples, [&](std::size_t i) { benchmark::DoNotOptimize(&iMap[samples[i]]); });
+	bench::reportMemory(state);
+}
+
+// Point lookups walking the key space in order, the access pattern of range reports
+template <typename K, typename V, typename Storage>
+static void BM_SequentialScan(benchmark::State& state)
+{
+	const auto iMap = bench::makeMap<K, V, Storage>(state.range(0));
+	const std::int64_t keyCount = state.range(0);
+	std::int64_t next = 0;
+
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < kOpsPerIteration; ++i)
+		{
+			benchmark::DoNotOptimize(&iMap[bench::makeKey<K>(next)]);
+			next = (next + 1 == keyCount) ? 0 : next + 1;
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kOpsPerIteration);
+
+	bench::reportLatency(state, kLatencySamples, [&](std::size_t i) { benchmark::DoNotOptimize(&iMap[bench::makeKey<K>(static_cast<std::int64_t>(i) % keyCount)]); });
+	bench::reportMemory(state);
+}
+
+// Full walk of the canonical intervals
+template <typename K, typename V, typename Storage>
+static void BM_IntervalScan(benchmark::State& state)
+{
+	const auto iMap = bench::makeMap<K, V, Storage>(state.range(0));
+
+	for (auto _ : state)
+	{
+		for (const auto& interval : iMap.intervals())
+		{
+			benchmark::DoNotOptimize(&interval.val);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * (iMap.getMap().size() - 1));
+	bench::reportMemory(state);
+}
+
+// Short intervals at random places: split an existing interval or replace one
+template <typename K, typename V, typename Storage>
+static void BM_InsertRandom(benchmark::State& state)
+{
+	const auto initial = bench::makeMap<K, V, Storage>(state.range(0));
+	const auto keys = makeRandomKeys<K>(state.range(0), kOpsPerIteration, 3);
+	auto iMap = initial;
+	std::size_t round = 0;
+
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < keys.size(); ++i)
+		{
+			iMap.insert(keys[i], keys[i] + static_cast<K>(8), bench::makeValue<V>(round + i));
+		}
+		++round;
+		keepSize(state, iMap, initial);
+	}
+	state.SetItemsProcessed(state.iterations() * keys.size());
+
+	bench::reportLatency(state, kLatencySamples, [&](std::size_t i)
+	{
+		const K& key = keys[i % keys.size()];
+		iMap.insert(key, key + static_cast<K>(8), bench::makeValue<V>(i));
+	});
+	bench::reportMemory(state);
+}
+
+// Long intervals each swallowing ~8 boundaries
+template <typename K, typename V, typename Storage>
+static void BM_InsertOverlapping(benchmark::State& state)
+{
+	const auto initial = bench::makeMap<K, V, Storage>(state.range(0));
+	const auto keys = makeRandomKeys<K>(state.range(0), kOpsPerIteration, 4);
+	const K length = bench::makeKey<K>(8);
+	auto iMap = initial;
+
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < keys.size(); ++i)
+		{
+			iMap.insert(keys[i], keys[i] + length, bench::makeValue<V>(i));
+			keepSize(state, iMap, initial);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * keys.size());
+
+	bench::reportLatency(state, kLatencySamples, [&](std::size_t i)
+	{
+		const K& key = keys[i % keys.size()];
+		iMap.insert(key, key + length, bench::makeValue<V>(i));
+	});
+	bench::reportMemory(state);
+}
+
+// Intervals appended one after another behind the last boundary, the shape of a time series feed
+template <typename K, typename V, typename Storage>
+static void BM_InsertAdjacent(benchmark::State& state)
+{
+	const auto initial = bench::makeMap<K, V, Storage>(state.range(0));
+	auto iMap = initial;
+	std::int64_t next = state.range(0);
+
+	auto append = [&](std::size_t i)
+	{
+		iMap.insert(bench::makeKey<K>(next), bench::makeKey<K>(next + 1), bench::makeValue<V>(i));
+		++next;
+	};
+
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < kOpsPerIteration; ++i)
+		{
+			append(i);
+		}
+		if (iMap.getMap().size() > 2 * initial.getMap().size())
+		{
+			state.PauseTiming();
+			iMap = initial;
+			next = state.range(0);
+			state.ResumeTiming();
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * kOpsPerIteration);
+
+	bench::reportLatency(state, kLatencySamples, append);
+	bench::reportMemory(state);
+}
+
+#define INTERVAL_MAP_LOOKUP_BENCHMARKS(K, V, Storage) \
+	BENCHMARK_TEMPLATE(BM_RandomLookup, K, V, Storage)->Apply(bench::applySizes<K>); \
+	BENCHMARK_TEMPLATE(BM_SequentialScan, K, V, Storage)->Apply(bench::applySizes<K>); \
+	BENCHMARK_TEMPLATE(BM_IntervalScan, K, V, Storage)->Apply(bench::applySizes<K>)
+
+#define INTERVAL_MAP_INSERT_BENCHMARKS(K, V, Storage) \
+	BENCHMARK_TEMPLATE(BM_InsertRandom, K, V, Storage)->Apply(bench::applySizes<K>); \
+	BENCHMARK_TEMPLATE(BM_InsertOverlapping, K, V, Storage)->Apply(bench::applySizes<K>); \
+	BENCHMARK_TEMPLATE(BM_InsertAdjacent, K, V, Storage)->Apply(bench::applySizes<K>)
+
+using IntVector = std::vector<int>; // Commas would split the macro arguments
+
+INTERVAL_MAP_LOOKUP_BENCHMARKS(int, int, DS::TreeStorage);
+INTERVAL_MAP_LOOKUP_BENCHMARKS(int, int, DS::FlatStorage);
+INTERVAL_MAP_LOOKUP_BENCHMARKS(float, int, DS::TreeStorage);
+INTERVAL_MAP_LOOKUP_BENCHMARKS(float, int, DS::FlatStorage);
+INTERVAL_MAP_LOOKUP_BENCHMARKS(int, float, DS::FlatStorage);
+INTERVAL_MAP_LOOKUP_BENCHMARKS(int, std::string, DS::TreeStorage);
+INTERVAL_MAP_LOOKUP_BENCHMARKS(int, std::string, DS::FlatStorage);
+INTERVAL_MAP_LOOKUP_BENCHMARKS(int, IntVector, DS::TreeStorage);
+INTERVAL_MAP_LOOKUP_BENCHMARKS(int, IntVector, DS::FlatStorage);
+
+INTERVAL_MAP_INSERT_BENCHMARKS(int, int, DS::TreeStorage);
+INTERVAL_MAP_INSERT_BENCHMARKS(int, int, DS::FlatStorage);
+INTERVAL_MAP_INSERT_BENCHMARKS(float, float, DS::TreeStorage);
+INTERVAL_MAP_INSERT_BENCHMARKS(int, std::string, DS::TreeStorage);
+INTERVAL_MAP_INSERT_BENCHMARKS(int, std::string, DS::FlatStorage);
+INTERVAL_MAP_INSERT_BENCHMARKS(int, IntVector, DS::TreeStorage);
+INTERVAL_MAP_INSERT_BENCHMARKS(int, IntVector, DS::FlatStorage);
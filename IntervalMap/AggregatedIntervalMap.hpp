@@ -0,0 +1,399 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Interval.hpp"
+#include "IntervalMap.hpp"
+
+namespace DS
+{
+	// Monoids over the pieces of a map. segment() summarizes the piece [keyBegin, keyEnd) holding val,
+	// combine() has to be associative with identity() as neutral element. Pieces are combined in key order,
+	// so combine() does not need to be commutative.
+
+	namespace detail
+	{
+		// Integral products are summed in 64 bits: int values over long int ranges overflow an int sum
+		template <typename K, typename V, typename Product = decltype(std::declval<V>() * (std::declval<K>() - std::declval<K>()))>
+		using WeightedSumType = std::conditional_t<std::is_integral_v<Product>,
+			std::conditional_t<std::is_signed_v<Product>, std::int64_t, std::uint64_t>,
+			Product>;
+	}
+
+	// Integral of the value over the keys, e.g. capacity times duration, accumulated in Sum
+	template <typename K, typename V, typename Sum = detail::WeightedSumType<K, V>>
+	struct WeightedSum
+	{
+		using value_type = Sum;
+
+		static Sum identity() { return Sum{}; }
+		static Sum segment(const K& keyBegin, const K& keyEnd, const V& val)
+		{
+			// Arithmetic keys are subtracted in Sum as well, the distance of two ints may not fit an int
+			if constexpr (std::is_arithmetic_v<K> && std::is_arithmetic_v<V>)
+			{
+				return static_cast<Sum>(val) * (static_cast<Sum>(keyEnd) - static_cast<Sum>(keyBegin));
+			}
+			else
+			{
+				return static_cast<Sum>(val * (keyEnd - keyBegin));
+			}
+		}
+		static Sum combine(const Sum& lhs, const Sum& rhs) { return lhs + rhs; }
+	};
+
+	// Min and Max take their identity from std::numeric_limits, which only holds real bounds for arithmetic types
+	template <typename K, typename V>
+		requires std::is_arithmetic_v<V>
+	struct Min
+	{
+		using value_type = V;
+
+		static V identity() { return std::numeric_limits<V>::max(); }
+		static V segment(const K&, const K&, const V& val) { return val; }
+		static V combine(const V& lhs, const V& rhs) { return (rhs < lhs) ? rhs : lhs; }
+	};
+
+	template <typename K, typename V>
+		requires std::is_arithmetic_v<V>
+	struct Max
+	{
+		using value_type = V;
+
+		static V identity() { return std::numeric_limits<V>::lowest(); }
+		static V segment(const K&, const K&, const V& val) { return val; }
+		static V combine(const V& lhs, const V& rhs) { return (lhs < rhs) ? rhs : lhs; }
+	};
+
+	// Number of maximal pieces: value changes inside the window, plus one
+	template <typename K, typename V>
+	struct SegmentCount
+	{
+		using value_type = std::size_t;
+
+		static std::size_t identity() { return 0; }
+		static std::size_t segment(const K&, const K&, const V&) { return 1; }
+		static std::size_t combine(std::size_t lhs, std::size_t rhs) { return lhs + rhs; }
+	};
+
+	// Interval map answering aggregate(lo, hi) in O(log n). Boundaries live in a treap (a randomized balanced
+	// search tree) whose nodes cache the monoid of the pieces between the boundaries of their subtree,
+	// together with the first and last boundary of it: the piece joining two subtrees is known from those alone.
+	// insert() keeps the cache up to date along the O(log n) nodes it splits and merges.
+	// Same canonical form and operator[] semantics as IntervalMap.
+	template <typename K, typename V, typename Monoid = WeightedSum<K, V>>
+	class AggregatedIntervalMap
+	{
+		public:
+
+			using Aggregate = typename Monoid::value_type;
+
+		private:
+
+			struct Node
+			{
+				K key;
+				V val;
+				std::uint32_t priority;
+				std::unique_ptr<Node> left;
+				std::unique_ptr<Node> right;
+
+				// Cache of the subtree
+				Aggregate agg;
+				const Node* first;
+				const Node* last;
+			};
+
+			// Aggregate of the pieces between consecutive boundaries of a set of them. The piece starting
+			// at the last boundary is still open: its end comes from whatever is joined on the right.
+			struct Summary
+			{
+				Aggregate agg = Monoid::identity();
+				const Node* first = nullptr;
+				const Node* last = nullptr;
+			};
+
+		public:
+
+			AggregatedIntervalMap()
+			:
+				AggregatedIntervalMap(V{})
+			{}
+
+			template<typename V_forward>
+				requires (!std::is_same_v<std::remove_cvref_t<V_forward>, AggregatedIntervalMap>)
+			AggregatedIntervalMap(V_forward&& val)
+			:
+				m_valBegin(std::forward<V_forward>(val))
+			{}
+
+			AggregatedIntervalMap(const AggregatedIntervalMap& other)
+			:
+				m_valBegin(other.m_valBegin),
+				m_root(clone(other.m_root.get())),
+				m_size(other.m_size),
+				m_seed(other.m_seed)
+			{}
+
+			AggregatedIntervalMap& operator=(const AggregatedIntervalMap& other)
+			{
+				if (this != &other)
+				{
+					*this = AggregatedIntervalMap(other);
+				}
+				return *this;
+			}
+
+			AggregatedIntervalMap(AggregatedIntervalMap&&) = default;
+			AggregatedIntervalMap& operator=(AggregatedIntervalMap&&) = default;
+
+		public:
+
+			template<typename V_forward>
+			void insert(const K& keyBegin, const K& keyEnd, V_forward&& val)
+			{
+				if (!(keyBegin < keyEnd)) return;
+
+				// Boundaries below keyBegin, inside [keyBegin, keyEnd], above keyEnd
+				auto [below, rest] = split<false>(std::move(m_root), keyBegin);
+				auto [inside, above] = split<true>(std::move(rest), keyEnd);
+
+				const V& prevVal = below ? below->last->val : m_valBegin;
+				V endVal = inside ? inside->last->val : prevVal;
+
+				std::unique_ptr<Node> middle;
+				if (!(val == prevVal))
+				{
+					middle = makeNode(keyBegin, std::forward<V_forward>(val));
+				}
+				const V& newVal = middle ? middle->val : prevVal;
+				if (!(endVal == newVal))
+				{
+					middle = merge(std::move(middle), makeNode(keyEnd, std::move(endVal)));
+				}
+
+				m_size -= count(inside.get());
+				m_size += count(middle.get());
+				inside.reset();
+				m_root = merge(merge(std::move(below), std::move(middle)), std::move(above));
+			}
+
+			V const& operator[](K const& key) const
+			{
+				const Node* floor = nullptr;
+				for (const Node* node = m_root.get(); node != nullptr;)
+				{
+					if (key < node->key)
+					{
+						node = node->left.get();
+					}
+					else
+					{
+						floor = node;
+						node = node->right.get();
+					}
+				}
+				return floor ? floor->val : m_valBegin;
+			}
+
+			// Monoid of the pieces covering [lo, hi), clipped to it. The piece at lo and the one reaching hi
+			// are partial ones, the valBegin regions count as pieces as well.
+			Aggregate aggregate(const K& lo, const K& hi) const
+			{
+				if (!(lo < hi)) return Monoid::identity();
+
+				const V& valLo = (*this)[lo];
+				const Summary inside = collect(m_root.get(), lo, hi);
+				if (!inside.first)
+				{
+					return Monoid::segment(lo, hi, valLo);
+				}
+
+				return Monoid::combine(
+					Monoid::combine(Monoid::segment(lo, inside.first->key, valLo), inside.agg),
+					Monoid::segment(inside.last->key, hi, inside.last->val));
+			}
+
+			// Number of boundaries
+			std::size_t size() const { return m_size; }
+			bool empty() const { return m_size == 0; }
+
+			const V& valBegin() const { return m_valBegin; }
+
+			// Copies the content into a regular map
+			template <typename Storage = TreeStorage>
+			IntervalMap<K, V, Storage> toIntervalMap() const
+			{
+				std::vector<Interval<K, V>> intervals;
+				intervals.reserve(m_size);
+				const Node* prev = nullptr;
+				forEach(m_root.get(), [&intervals, &prev](const Node& node)
+				{
+					if (prev) intervals.push_back({ prev->key, node.key, prev->val });
+					prev = &node;
+				});
+
+				IntervalMap<K, V, Storage> iMap(m_valBegin);
+				iMap.assignSorted(intervals.begin(), intervals.end());
+				return iMap;
+			}
+
+		private:
+
+			static Summary summary(const Node* node)
+			{
+				return node ? Summary{ node->agg, node->first, node->last } : Summary{};
+			}
+
+			// lhs boundaries all lie before the ones of rhs
+			static Summary join(const Summary& lhs, const Summary& rhs)
+			{
+				if (!lhs.first) return rhs;
+				if (!rhs.first) return lhs;
+
+				const Aggregate between = Monoid::segment(lhs.last->key, rhs.first->key, lhs.last->val);
+				return { Monoid::combine(Monoid::combine(lhs.agg, between), rhs.agg), lhs.first, rhs.last };
+			}
+
+			static Summary leaf(const Node* node)
+			{
+				return { Monoid::identity(), node, node };
+			}
+
+			static void update(Node* node)
+			{
+				const Summary s = join(join(summary(node->left.get()), leaf(node)), summary(node->right.get()));
+				node->agg = s.agg;
+				node->first = s.first;
+				node->last = s.last;
+			}
+
+			// Boundaries in the open range (lo, hi), O(depth): the walk forks once, then each side
+			// takes whole subtrees from one path
+			static Summary collect(const Node* node, const K& lo, const K& hi)
+			{
+				while (node)
+				{
+					if (!(lo < node->key))
+					{
+						node = node->right.get();
+					}
+					else if (!(node->key < hi))
+					{
+						node = node->left.get();
+					}
+					else
+					{
+						return join(join(collectAbove(node->left.get(), lo), leaf(node)), collectBelow(node->right.get(), hi));
+					}
+				}
+				return {};
+			}
+
+			// Boundaries > lo
+			static Summary collectAbove(const Node* node, const K& lo)
+			{
+				if (!node) return {};
+				if (!(lo < node->key)) return collectAbove(node->right.get(), lo);
+				return join(join(collectAbove(node->left.get(), lo), leaf(node)), summary(node->right.get()));
+			}
+
+			// Boundaries < hi
+			static Summary collectBelow(const Node* node, const K& hi)
+			{
+				if (!node) return {};
+				if (!(node->key < hi)) return collectBelow(node->left.get(), hi);
+				return join(join(summary(node->left.get()), leaf(node)), collectBelow(node->right.get(), hi));
+			}
+
+			// Inclusive: (keys <= key, keys > key), otherwise (keys < key, keys >= key)
+			template <bool Inclusive>
+			static std::pair<std::unique_ptr<Node>, std::unique_ptr<Node>> split(std::unique_ptr<Node> node, const K& key)
+			{
+				if (!node) return {};
+
+				const bool goesLeft = Inclusive ? !(key < node->key) : node->key < key;
+				if (goesLeft)
+				{
+					auto [lhs, rhs] = split<Inclusive>(std::move(node->right), key);
+					node->right = std::move(lhs);
+					update(node.get());
+					return { std::move(node), std::move(rhs) };
+				}
+				else
+				{
+					auto [lhs, rhs] = split<Inclusive>(std::move(node->left), key);
+					node->left = std::move(rhs);
+					update(node.get());
+					return { std::move(lhs), std::move(node) };
+				}
+			}
+
+			// Every key of lhs is less than every key of rhs
+			static std::unique_ptr<Node> merge(std::unique_ptr<Node> lhs, std::unique_ptr<Node> rhs)
+			{
+				if (!lhs) return rhs;
+				if (!rhs) return lhs;
+
+				if (lhs->priority > rhs->priority)
+				{
+					lhs->right = merge(std::move(lhs->right), std::move(rhs));
+					update(lhs.get());
+					return lhs;
+				}
+				rhs->left = merge(std::move(lhs), std::move(rhs->left));
+				update(rhs.get());
+				return rhs;
+			}
+
+			template <typename V_forward>
+			std::unique_ptr<Node> makeNode(const K& key, V_forward&& val)
+			{
+				// xorshift32, balance only needs the priorities to look independent
+				m_seed ^= m_seed << 13;
+				m_seed ^= m_seed >> 17;
+				m_seed ^= m_seed << 5;
+
+				auto node = std::make_unique<Node>(Node{ key, std::forward<V_forward>(val), m_seed, nullptr, nullptr, Monoid::identity(), nullptr, nullptr });
+				update(node.get());
+				return node;
+			}
+
+			static std::unique_ptr<Node> clone(const Node* node)
+			{
+				if (!node) return nullptr;
+
+				auto copy = std::make_unique<Node>(Node{ node->key, node->val, node->priority, clone(node->left.get()), clone(node->right.get()), Monoid::identity(), nullptr, nullptr });
+				update(copy.get());
+				return copy;
+			}
+
+			static std::size_t count(const Node* node)
+			{
+				return node ? 1 + count(node->left.get()) + count(node->right.get()) : 0;
+			}
+
+			template <typename Func>
+			static void forEach(const Node* node, Func&& func)
+			{
+				if (!node) return;
+
+				forEach(node->left.get(), func);
+				func(*node);
+				forEach(node->right.get(), func);
+			}
+
+		private:
+
+			V m_valBegin;
+			std::unique_ptr<Node> m_root;
+			std::size_t m_size = 0;
+			std::uint32_t m_seed = 2463534242u;
+	};
+}
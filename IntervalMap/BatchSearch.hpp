@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace DS::detail
+{
+	// Search kernels over a sorted contiguous array of boundaries.
+	// Each of them reports upper_bound positions (number of boundaries <= key) through sink(keyIndex, position).
+
+	// Number of searches interleaved by the scalar kernel, enough to hide most of the load latency
+	inline constexpr std::size_t kSearchLanes = 8;
+
+	// Branch free upper_bound: the loop trip count depends only on size, never on the data
+	template <typename K>
+	std::size_t branchlessUpperBound(const K* bounds, std::size_t size, const K& key)
+	{
+		if (size == 0) return 0;
+
+		const K* base = bounds;
+		std::size_t len = size;
+		while (len > 1)
+		{
+			const std::size_t half = len / 2;
+			base = (key < base[half]) ? base : base + half;
+			len -= half;
+		}
+		return static_cast<std::size_t>(base - bounds) + !(key < *base);
+	}
+
+#if defined(__AVX2__)
+	// 8 lanes of the branchless search at once, gathering the probed boundaries
+	template <typename K>
+	inline constexpr bool kHasSimdSearch = (std::is_same_v<K, std::int32_t> || std::is_same_v<K, float>);
+
+	template <typename K, typename Sink>
+	std::size_t simdUpperBoundBatch(const K* bounds, std::size_t size, const K* keys, std::size_t count, Sink& sink)
+	{
+		// Gather indices are 32 bit
+		if (size == 0 || size > static_cast<std::size_t>(INT32_MAX)) return 0;
+
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i base = _mm256_setzero_si256();
+			__m256i isGreater;
+			std::size_t len = size;
+
+			if constexpr (std::is_same_v<K, float>)
+			{
+				const __m256 key = _mm256_loadu_ps(keys + i);
+				while (len > 1)
+				{
+					const std::size_t half = len / 2;
+					const __m256i probe = _mm256_add_epi32(base, _mm256_set1_epi32(static_cast<int>(half)));
+					const __m256 val = _mm256_i32gather_ps(bounds, probe, 4);
+					isGreater = _mm256_castps_si256(_mm256_cmp_ps(val, key, _CMP_GT_OQ));
+					base = _mm256_blendv_epi8(probe, base, isGreater);
+					len -= half;
+				}
+				isGreater = _mm256_castps_si256(_mm256_cmp_ps(_mm256_i32gather_ps(bounds, base, 4), key, _CMP_GT_OQ));
+			}
+			else
+			{
+				const __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+				const int* data = reinterpret_cast<const int*>(bounds);
+				while (len > 1)
+				{
+					const std::size_t half = len / 2;
+					const __m256i probe = _mm256_add_epi32(base, _mm256_set1_epi32(static_cast<int>(half)));
+					const __m256i val = _mm256_i32gather_epi32(data, probe, 4);
+					isGreater = _mm256_cmpgt_epi32(val, key);
+					base = _mm256_blendv_epi8(probe, base, isGreater);
+					len -= half;
+				}
+				isGreater = _mm256_cmpgt_epi32(_mm256_i32gather_epi32(data, base, 4), key);
+			}
+
+			// Mask lanes are -1 where the last probed boundary is greater than the key
+			alignas(32) std::int32_t pos[8];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(pos), _mm256_add_epi32(_mm256_add_epi32(base, _mm256_set1_epi32(1)), isGreater));
+			for (std::size_t lane = 0; lane < 8; ++lane)
+			{
+				sink(i + lane, static_cast<std::size_t>(pos[lane]));
+			}
+		}
+		return i;
+	}
+#else
+	template <typename K>
+	inline constexpr bool kHasSimdSearch = false;
+#endif
+
+	template <typename K, typename Sink>
+	void upperBoundBatch(const K* bounds, std::size_t size, const K* keys, std::size_t count, Sink&& sink)
+	{
+		std::size_t i = 0;
+
+		if constexpr (std::is_arithmetic_v<K>)
+		{
+#if defined(__AVX2__)
+			if constexpr (kHasSimdSearch<K>)
+			{
+				i = simdUpperBoundBatch(bounds, size, keys, count, sink);
+			}
+#endif
+			// Interleaved scalar searches: independent loads of several lanes overlap in the pipeline
+			for (; size != 0 && i + kSearchLanes <= count; i += kSearchLanes)
+			{
+				const K* base[kSearchLanes];
+				std::fill(std::begin(base), std::end(base), bounds);
+
+				std::size_t len = size;
+				while (len > 1)
+				{
+					const std::size_t half = len / 2;
+					for (std::size_t lane = 0; lane < kSearchLanes; ++lane)
+					{
+						base[lane] = (keys[i + lane] < base[lane][half]) ? base[lane] : base[lane] + half;
+					}
+					len -= half;
+				}
+				for (std::size_t lane = 0; lane < kSearchLanes; ++lane)
+				{
+					sink(i + lane, static_cast<std::size_t>(base[lane] - bounds) + !(keys[i + lane] < *base[lane]));
+				}
+			}
+			for (; i < count; ++i)
+			{
+				sink(i, branchlessUpperBound(bounds, size, keys[i]));
+			}
+		}
+		else
+		{
+			for (; i < count; ++i)
+			{
+				sink(i, static_cast<std::size_t>(std::upper_bound(bounds, bounds + size, keys[i]) - bounds));
+			}
+		}
+	}
+
+	// Keys must be sorted. Galloping from the previous answer costs O(log d) for a distance d between answers.
+	template <typename K, typename Sink>
+	void upperBoundSortedBatch(const K* bounds, std::size_t size, const K* keys, std::size_t count, Sink&& sink)
+	{
+		std::size_t pos = 0;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const K& key = keys[i];
+
+			std::size_t lo = pos;
+			std::size_t hi = pos;
+			std::size_t step = 1;
+			while (hi < size && !(key < bounds[hi]))
+			{
+				lo = hi + 1;
+				hi = lo + step;
+				step *= 2;
+			}
+			hi = std::min(hi, size);
+
+			pos = static_cast<std::size_t>(std::upper_bound(bounds + lo, bounds + hi, key) - bounds);
+			sink(i, pos);
+		}
+	}
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "IntervalMap.hpp"
+
+namespace DS
+{
+	// On-disk layout, every field little-endian:
+	//   binary::Header
+	//   valBegin                        at header.valBeginOffset
+	//   K keys[header.count]            at header.keysOffset, 64-byte aligned
+	//   V values[header.count]          at header.valuesOffset, 64-byte aligned
+	// Keys and values are stored as the boundaries of the canonical map, so a reader can search them in place.
+	namespace binary
+	{
+		inline constexpr std::array<char, 8> kMagic = { 'D', 'S', 'I', 'V', 'M', 'A', 'P', '\0' };
+		inline constexpr std::uint32_t kVersion = 1;
+		inline constexpr std::size_t kArrayAlignment = 64;
+
+		struct Header
+		{
+			std::array<char, 8> magic;
+			std::uint32_t version;
+			std::uint32_t keySize;
+			std::uint32_t valSize;
+			std::uint32_t reserved;
+			std::uint64_t count;
+			std::uint64_t valBeginOffset;
+			std::uint64_t keysOffset;
+			std::uint64_t valuesOffset;
+		};
+
+		// Scalars are byte swapped on big-endian hosts. Other trivially copyable types have no defined byte order.
+		template <typename T>
+		inline constexpr bool kIsPortable = std::is_trivially_copyable_v<T> &&
+			(std::is_arithmetic_v<T> || std::endian::native == std::endian::little);
+
+		template <typename T>
+		T toLittle(T value)
+		{
+			if constexpr (std::endian::native == std::endian::big && std::is_arithmetic_v<T>)
+			{
+				auto bytes = std::bit_cast<std::array<std::byte, sizeof(T)>>(value);
+				std::reverse(bytes.begin(), bytes.end());
+				return std::bit_cast<T>(bytes);
+			}
+			return value;
+		}
+
+		template <typename T>
+		T fromLittle(T value)
+		{
+			return toLittle(value);
+		}
+
+		constexpr std::uint64_t alignUp(std::uint64_t offset)
+		{
+			return (offset + kArrayAlignment - 1) / kArrayAlignment * kArrayAlignment;
+		}
+
+		template <typename K, typename V>
+		Header makeHeader(std::uint64_t count)
+		{
+			Header header{};
+			header.magic = kMagic;
+			header.version = kVersion;
+			header.keySize = sizeof(K);
+			header.valSize = sizeof(V);
+			header.count = count;
+			header.valBeginOffset = sizeof(Header);
+			header.keysOffset = alignUp(header.valBeginOffset + sizeof(V));
+			header.valuesOffset = alignUp(header.keysOffset + count * sizeof(K));
+			return header;
+		}
+
+		// Reads and validates the header at the start of data. Throws std::runtime_error if K/V do not match the file.
+		template <typename K, typename V>
+		Header readHeader(const std::byte* data, std::size_t size)
+		{
+			Header header;
+			if (size < sizeof(Header)) throw std::runtime_error("IntervalMap binary: file too small");
+			std::memcpy(&header, data, sizeof(Header));
+
+			header.version = fromLittle(header.version);
+			header.keySize = fromLittle(header.keySize);
+			header.valSize = fromLittle(header.valSize);
+			header.count = fromLittle(header.count);
+			header.valBeginOffset = fromLittle(header.valBeginOffset);
+			header.keysOffset = fromLittle(header.keysOffset);
+			header.valuesOffset = fromLittle(header.valuesOffset);
+
+			if (header.magic != kMagic) throw std::runtime_error("IntervalMap binary: bad magic");
+			if (header.version != kVersion) throw std::runtime_error("IntervalMap binary: unsupported version " + std::to_string(header.version));
+			if (header.keySize != sizeof(K) || header.valSize != sizeof(V)) throw std::runtime_error("IntervalMap binary: key or value size mismatch");
+
+			// Written as differences: a corrupted offset near 2^64 must not wrap around into range
+			const bool fits = header.valBeginOffset <= size && sizeof(V) <= size - header.valBeginOffset &&
+				header.keysOffset <= size && header.count <= (size - header.keysOffset) / sizeof(K) &&
+				header.valuesOffset <= size && header.count <= (size - header.valuesOffset) / sizeof(V);
+			const bool aligned = header.keysOffset % alignof(K) == 0 && header.valuesOffset % alignof(V) == 0 && header.valBeginOffset % alignof(V) == 0;
+			if (!fits || !aligned) throw std::runtime_error("IntervalMap binary: corrupted layout");
+
+			return header;
+		}
+
+		// Streams a range of elements through a bounded buffer, converting to little-endian on the way
+		template <typename T, typename InputIt, typename Project>
+		void writeArray(std::ostream& out, InputIt first, InputIt last, Project project)
+		{
+			constexpr std::size_t kChunk = 4096;
+			std::vector<T> buffer;
+			buffer.reserve(kChunk);
+			for (; first != last; ++first)
+			{
+				buffer.push_back(toLittle<T>(project(*first)));
+				if (buffer.size() == kChunk)
+				{
+					out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(T)));
+					buffer.clear();
+				}
+			}
+			out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(T)));
+		}
+
+		inline void writePadding(std::ostream& out, std::uint64_t from, std::uint64_t to)
+		{
+			static constexpr char zeros[kArrayAlignment] = {};
+			out.write(zeros, static_cast<std::streamsize>(to - from));
+		}
+	}
+
+	// Writes the map front to back in the binary layout above. Flat storages on little-endian hosts
+	// hand their arrays to the stream as they are, other ones go through a small conversion buffer.
+	template <typename K, typename V, typename Storage, typename Allocator, typename Stats>
+	void writeBinary(const IntervalMap<K, V, Storage, Allocator, Stats>& iMap, std::ostream& out)
+	{
+		static_assert(binary::kIsPortable<K> && binary::kIsPortable<V>, "Binary format needs trivially copyable K and V with a defined byte order");
+
+		const auto& map = iMap.getMap();
+		const binary::Header header = binary::makeHeader<K, V>(map.size());
+
+		binary::Header stored = header;
+		stored.version = binary::toLittle(stored.version);
+		stored.keySize = binary::toLittle(stored.keySize);
+		stored.valSize = binary::toLittle(stored.valSize);
+		stored.count = binary::toLittle(stored.count);
+		stored.valBeginOffset = binary::toLittle(stored.valBeginOffset);
+		stored.keysOffset = binary::toLittle(stored.keysOffset);
+		stored.valuesOffset = binary::toLittle(stored.valuesOffset);
+		out.write(reinterpret_cast<const char*>(&stored), sizeof(stored));
+
+		const V valBegin = binary::toLittle(iMap.valBegin());
+		out.write(reinterpret_cast<const char*>(&valBegin), sizeof(V));
+		binary::writePadding(out, header.valBeginOffset + sizeof(V), header.keysOffset);
+
+		if constexpr (std::endian::native == std::endian::little && requires { map.keys().data(); map.values().data(); })
+		{
+			out.write(reinterpret_cast<const char*>(map.keys().data()), static_cast<std::streamsize>(map.size() * sizeof(K)));
+			binary::writePadding(out, header.keysOffset + map.size() * sizeof(K), header.valuesOffset);
+			out.write(reinterpret_cast<const char*>(map.values().data()), static_cast<std::streamsize>(map.size() * sizeof(V)));
+		}
+		else
+		{
+			binary::writeArray<K>(out, map.begin(), map.end(), [](const auto& boundary) { return boundary.first; });
+			binary::writePadding(out, header.keysOffset + map.size() * sizeof(K), header.valuesOffset);
+			binary::writeArray<V>(out, map.begin(), map.end(), [](const auto& boundary) { return boundary.second; });
+		}
+
+		if (!out) throw std::runtime_error("IntervalMap binary: write failed");
+	}
+
+	template <typename K, typename V, typename Storage, typename Allocator, typename Stats>
+	void saveBinary(const IntervalMap<K, V, Storage, Allocator, Stats>& iMap, const std::string& path)
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out) throw std::runtime_error("IntervalMap binary: cannot open '" + path + "'");
+
+		writeBinary(iMap, out);
+		out.flush();
+		if (!out) throw std::runtime_error("IntervalMap binary: write failed '" + path + "'");
+	}
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "IntervalMap.hpp"
+
+namespace DS
+{
+	// Lookup front-end for streams of nearby keys. Remembers the piece [lo, hi) of the last hit and answers
+	// keys inside it with two compares; a key in one of the two neighbouring pieces moves the cursor one
+	// boundary, anything else falls back to a full upper_bound. The remembered piece is dropped whenever
+	// the version of the map changes, so inserts between lookups are always seen.
+	// One cursor per thread: lookups update it, and the map must not be written while it is read.
+	template <typename IntervalMapT>
+	class CachedLookup
+	{
+		private:
+
+			using K = typename IntervalMapT::MapType::key_type;
+			using V = typename IntervalMapT::MapType::mapped_type;
+			using BoundaryIt = typename IntervalMapT::MapType::const_iterator;
+
+		public:
+
+			explicit CachedLookup(const IntervalMapT& iMap)
+			:
+				m_iMap(iMap)
+			{
+				seek(iMap.getMap().begin());
+			}
+
+		public:
+
+			V const& operator[](K const& key)
+			{
+				if (m_version == m_iMap.version())
+				{
+					if ((!m_lo || !(key < *m_lo)) && (!m_hi || key < *m_hi))
+					{
+						++m_hits;
+						return *m_val;
+					}
+
+					const auto& map = m_iMap.getMap();
+					if (m_hi && !(key < *m_hi))
+					{
+						// Next piece: [m_hi, the boundary after it)
+						const auto next = std::next(m_it);
+						if (next == map.end() || key < next->first)
+						{
+							++m_hits;
+							return seek(next);
+						}
+					}
+					else
+					{
+						// Previous piece: [the boundary before m_lo, m_lo)
+						const auto prev = std::prev(m_it);
+						if (prev == map.begin() || !(key < std::prev(prev)->first))
+						{
+							++m_hits;
+							return seek(prev);
+						}
+					}
+				}
+
+				++m_misses;
+				return seek(m_iMap.getMap().upper_bound(key));
+			}
+
+			// Lookups answered from the remembered piece or one of its neighbours
+			std::uint64_t hits() const { return m_hits; }
+
+			// Lookups which searched the whole map
+			std::uint64_t misses() const { return m_misses; }
+
+		private:
+
+			// Remembers the piece which ends at it, i.e. it = upper_bound(key) of its keys
+			const V& seek(BoundaryIt it)
+			{
+				const auto& map = m_iMap.getMap();
+				m_version = m_iMap.version();
+				m_it = it;
+				m_hi = (it == map.end()) ? nullptr : &it->first;
+				if (it == map.begin())
+				{
+					m_lo = nullptr;
+					m_val = &m_iMap.valBegin();
+				}
+				else
+				{
+					const auto prev = std::prev(it);
+					m_lo = &prev->first;
+					m_val = &prev->second;
+				}
+				return *m_val;
+			}
+
+		private:
+
+			const IntervalMapT& m_iMap;
+			std::uint64_t m_version = 0;
+
+			// Piece [*m_lo, *m_hi) holding *m_val, a null bound is unbounded. They point into the map
+			// and are only read while m_version is current.
+			BoundaryIt m_it;
+			const K* m_lo = nullptr;
+			const K* m_hi = nullptr;
+			const V* m_val = nullptr;
+
+			std::uint64_t m_hits = 0;
+			std::uint64_t m_misses = 0;
+	};
+
+	template <typename K, typename V, typename Storage, typename Allocator, typename Stats>
+	CachedLookup<IntervalMap<K, V, Storage, Allocator, Stats>> cachedLookup(const IntervalMap<K, V, Storage, Allocator, Stats>& iMap)
+	{
+		return CachedLookup<IntervalMap<K, V, Storage, Allocator, Stats>>(iMap);
+	}
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "IntervalMap.hpp"
+
+namespace DS
+{
+	namespace detail
+	{
+		// Below this amount of boundaries the work is not worth a thread
+		inline constexpr std::size_t kMinBoundariesPerThread = 1 << 16;
+
+		// threadCount - 1 keys splitting the boundaries of map in equal parts
+		template <typename Map>
+		auto splitKeysOf(const Map& map, std::size_t threadCount)
+		{
+			using K = typename Map::key_type;
+
+			std::vector<K> splits;
+			if (map.empty()) return splits;
+
+			auto it = map.begin();
+			std::size_t pos = 0;
+			for (std::size_t t = 1; t < threadCount; ++t)
+			{
+				const std::size_t target = t * map.size() / threadCount;
+				std::advance(it, static_cast<std::ptrdiff_t>(target - pos)); // O(1) on flat storages, a walk on trees
+				pos = target;
+				if (splits.empty() || splits.back() < it->first)
+				{
+					splits.push_back(it->first);
+				}
+			}
+			return splits;
+		}
+
+		// Boundaries of f(a, b) inside [lo, hi), a missing bound is unbounded. Canonical inside the range, except
+		// that a range with a lower bound always starts with a boundary at lo: whether it is redundant depends
+		// on the range before and is decided when the ranges are stitched.
+		template <typename K, typename R, typename MapA, typename MapB, typename F>
+		std::vector<std::pair<K, R>> combineRange(const MapA& lhs, const MapB& rhs, const std::optional<K>& lo, const std::optional<K>& hi, F& f)
+		{
+			const auto& mapA = lhs.getMap();
+			const auto& mapB = rhs.getMap();
+
+			auto itA = lo ? mapA.upper_bound(*lo) : mapA.begin();
+			auto itB = lo ? mapB.upper_bound(*lo) : mapB.begin();
+			const auto* valA = (itA == mapA.begin()) ? &lhs.valBegin() : &std::prev(itA)->second;
+			const auto* valB = (itB == mapB.begin()) ? &rhs.valBegin() : &std::prev(itB)->second;
+
+			std::vector<std::pair<K, R>> out;
+			std::optional<R> current;
+			if (lo)
+			{
+				out.emplace_back(*lo, f(*valA, *valB));
+			}
+			else
+			{
+				current = f(*valA, *valB);
+			}
+
+			while (itA != mapA.end() || itB != mapB.end())
+			{
+				// Next elementary segment starts at the smaller of both next boundaries
+				const bool takeA = itA != mapA.end() && (itB == mapB.end() || !(itB->first < itA->first));
+				const bool takeB = itB != mapB.end() && (itA == mapA.end() || !(itA->first < itB->first));
+				const K& key = takeA ? itA->first : itB->first;
+				if (hi && !(key < *hi)) break;
+
+				if (takeA) valA = &(itA++)->second;
+				if (takeB) valB = &(itB++)->second;
+
+				R val = f(*valA, *valB);
+				const R& last = out.empty() ? *current : out.back().second;
+				if (!(val == last))
+				{
+					out.emplace_back(key, std::move(val));
+				}
+			}
+			return out;
+		}
+	}
+
+	// Map of f(lhs[k], rhs[k]) for every key k, in canonical form, valBegin being f(lhs.valBegin(), rhs.valBegin()).
+	// One linear merge of both boundary sets: O(n + m) calls of f. With threadCount > 1 the key range is split between
+	// that many threads (0 picks one per core for large maps), only the final assembly of the result is sequential.
+	// Every thread calls its own copy of f, so a stateful f is fine as long as its copies do not share state.
+	template <typename K, typename VA, typename VB, typename Storage, typename AllocatorA, typename StatsA, typename StorageB, typename AllocatorB, typename StatsB, typename F>
+	auto combine(const IntervalMap<K, VA, Storage, AllocatorA, StatsA>& lhs, const IntervalMap<K, VB, StorageB, AllocatorB, StatsB>& rhs, F&& f, std::size_t threadCount = 1)
+	{
+		using R = std::decay_t<std::invoke_result_t<F&, const VA&, const VB&>>;
+
+		if (threadCount == 0)
+		{
+			threadCount = std::min<std::size_t>(
+				std::max(1u, std::thread::hardware_concurrency()),
+				(lhs.getMap().size() + rhs.getMap().size()) / detail::kMinBoundariesPerThread);
+		}
+
+		// Split keys come from the larger map, so both halves of the work are balanced by it
+		std::vector<K> splits = (lhs.getMap().size() < rhs.getMap().size())
+			? detail::splitKeysOf(rhs.getMap(), std::max<std::size_t>(threadCount, 1))
+			: detail::splitKeysOf(lhs.getMap(), std::max<std::size_t>(threadCount, 1));
+
+		std::vector<std::vector<std::pair<K, R>>> parts(splits.size() + 1);
+		auto run = [&](std::size_t i, auto& fn)
+		{
+			const std::optional<K> lo = (i == 0) ? std::nullopt : std::optional<K>(splits[i - 1]);
+			const std::optional<K> hi = (i == splits.size()) ? std::nullopt : std::optional<K>(splits[i]);
+			parts[i] = detail::combineRange<K, R>(lhs, rhs, lo, hi, fn);
+		};
+
+		if (parts.size() == 1)
+		{
+			run(0, f);
+		}
+		else
+		{
+			// Copied before any thread starts, f itself is not touched concurrently
+			std::vector<std::decay_t<F>> copies(parts.size(), f);
+			std::vector<std::thread> workers;
+			for (std::size_t i = 0; i < parts.size(); ++i)
+			{
+				workers.emplace_back([&run, &copies, i]() { run(i, copies[i]); });
+			}
+			for (auto& worker : workers)
+			{
+				worker.join();
+			}
+		}
+
+		// Every boundary ends where the next one starts; the last one holds valBegin, as both maps end with theirs.
+		// assignSorted() drops the boundaries at split keys which do not change the value.
+		std::vector<Interval<K, R>> intervals;
+		std::optional<std::pair<K, R>> previous;
+		for (auto& part : parts)
+		{
+			for (auto& boundary : part)
+			{
+				if (previous)
+				{
+					intervals.push_back({ std::move(previous->first), boundary.first, std::move(previous->second) });
+				}
+				previous = std::move(boundary);
+			}
+		}
+
+		IntervalMap<K, R, Storage> result(f(lhs.valBegin(), rhs.valBegin()));
+		assert(!previous || previous->second == result.valBegin());
+		result.assignSorted(std::make_move_iterator(intervals.begin()), std::make_move_iterator(intervals.end()));
+		return result;
+	}
+
+	// Every interval of top applied over base: top wins wherever it differs from its own valBegin, which stands for
+	// "no override". Same result as inserting the non-valBegin intervals of top into a copy of base, in linear time.
+	template <typename K, typename V, typename Storage, typename Allocator, typename Stats, typename StorageTop, typename AllocatorTop, typename StatsTop>
+	IntervalMap<K, V, Storage> overlay(const IntervalMap<K, V, Storage, Allocator, Stats>& base, const IntervalMap<K, V, StorageTop, AllocatorTop, StatsTop>& top, std::size_t threadCount = 1)
+	{
+		const V& noOverride = top.valBegin();
+		return combine(base, top, [&noOverride](const V& lhs, const V& rhs) -> const V& { return (rhs == noOverride) ? lhs : rhs; }, threadCount);
+	}
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "BatchSearch.hpp"
+#include "IntervalMap.hpp"
+
+namespace DS
+{
+	namespace detail
+	{
+		// Bits [bit, bit + width) of a packed array, which has to hold one word of padding past its last value
+		inline std::uint64_t readBits(const std::uint64_t* words, std::uint64_t bit, unsigned width)
+		{
+			const std::uint64_t* word = words + (bit >> 6);
+			const unsigned shift = static_cast<unsigned>(bit & 63);
+
+			std::uint64_t value = word[0] >> shift;
+			if (shift + width > 64)
+			{
+				value |= word[1] << (64 - shift);
+			}
+			return (width == 64) ? value : value & ((std::uint64_t(1) << width) - 1);
+		}
+
+		class BitWriter
+		{
+			public:
+
+				void write(std::uint64_t value, unsigned width)
+				{
+					if (width == 0) return;
+
+					const unsigned shift = static_cast<unsigned>(m_bits & 63);
+					if (shift == 0) m_words.push_back(0);
+					m_words.back() |= value << shift;
+					if (shift + width > 64)
+					{
+						m_words.push_back(value >> (64 - shift));
+					}
+					m_bits += width;
+				}
+
+				std::uint64_t bits() const { return m_bits; }
+
+				// Padded with the word readBits() may touch past the end
+				std::vector<std::uint64_t> finish()
+				{
+					m_words.push_back(0);
+					m_words.shrink_to_fit();
+					return std::move(m_words);
+				}
+
+			private:
+
+				std::vector<std::uint64_t> m_words;
+				std::uint64_t m_bits = 0;
+		};
+	}
+
+	// Read-only, compressed snapshot of an IntervalMap with integer keys, for maps which do not fit in memory otherwise.
+	// Boundary keys are cut into blocks of kBlockSize: each block keeps its first key in a sampled top level index and
+	// the deltas between its keys bit-packed at the width of its largest delta. Values are dictionary coded: one
+	// entry per distinct value, boundaries hold fixed width codes. Canonical form never repeats a value on adjacent
+	// boundaries, so there are no runs to encode beyond that.
+	// A lookup is one search in the sampled index, then one partial decode of a single block.
+	template <typename K, typename V, typename Hash = std::hash<V>>
+	class CompressedIntervalMap
+	{
+		static_assert(std::is_integral_v<K>, "Keys are delta coded, they have to be integers");
+
+		private:
+
+			using Delta = std::make_unsigned_t<K>;
+
+			struct Block
+			{
+				std::uint64_t bitOffset;
+				std::uint8_t width;
+			};
+
+		public:
+
+			// Small enough to decode in a few cache lines, large enough for the index to stay small
+			static constexpr std::size_t kBlockSize = 64;
+
+		public:
+
+			template <typename Storage, typename Allocator, typename Stats>
+			explicit CompressedIntervalMap(const IntervalMap<K, V, Storage, Allocator, Stats>& iMap)
+			:
+				m_valBegin(iMap.valBegin()),
+				m_size(iMap.getMap().size())
+			{
+				const auto& map = iMap.getMap();
+				const std::size_t blockCount = (m_size + kBlockSize - 1) / kBlockSize;
+				m_blockKeys.reserve(blockCount);
+				m_blocks.reserve(blockCount);
+
+				// Values first: the code width has to be known before the codes are written
+				std::unordered_map<V, std::uint32_t, Hash> ids;
+				std::vector<std::uint32_t> codes;
+				codes.reserve(m_size);
+				for (const auto& [key, val] : map)
+				{
+					const auto [it, isNew] = ids.try_emplace(val, static_cast<std::uint32_t>(m_dictionary.size()));
+					if (isNew) m_dictionary.push_back(val);
+					codes.push_back(it->second);
+				}
+				m_codeWidth = static_cast<unsigned>(std::bit_width(m_dictionary.empty() ? 0 : m_dictionary.size() - 1));
+
+				detail::BitWriter codeWriter;
+				for (const std::uint32_t code : codes)
+				{
+					codeWriter.write(code, m_codeWidth);
+				}
+				m_codes = codeWriter.finish();
+
+				detail::BitWriter keyWriter;
+				auto it = map.begin();
+				for (std::size_t b = 0; b < blockCount; ++b)
+				{
+					const std::size_t count = std::min(kBlockSize, m_size - b * kBlockSize);
+
+					std::vector<Delta> deltas;
+					deltas.reserve(count);
+					const K first = it->first;
+					K prev = first;
+					for (++it; deltas.size() + 1 < count; ++it)
+					{
+						deltas.push_back(static_cast<Delta>(static_cast<Delta>(it->first) - static_cast<Delta>(prev)));
+						prev = it->first;
+					}
+
+					const Delta maxDelta = deltas.empty() ? 0 : *std::max_element(deltas.begin(), deltas.end());
+					const auto width = static_cast<std::uint8_t>(std::bit_width(maxDelta));
+
+					m_blockKeys.push_back(first);
+					m_blocks.push_back({ keyWriter.bits(), width });
+					for (const Delta delta : deltas)
+					{
+						keyWriter.write(delta, width);
+					}
+				}
+				m_deltas = keyWriter.finish();
+			}
+
+		public:
+
+			V const& operator[](K const& key) const
+			{
+				const std::size_t block = detail::branchlessUpperBound(m_blockKeys.data(), m_blockKeys.size(), key);
+				if (block == 0) return m_valBegin;
+
+				// Position of the last boundary <= key inside the block: deltas are summed until they pass key
+				const std::size_t b = block - 1;
+				const std::size_t count = std::min(kBlockSize, m_size - b * kBlockSize);
+				const Block& info = m_blocks[b];
+				const Delta offset = static_cast<Delta>(static_cast<Delta>(key) - static_cast<Delta>(m_blockKeys[b]));
+
+				Delta sum = 0;
+				std::size_t i = 1;
+				for (std::uint64_t bit = info.bitOffset; i < count; ++i, bit += info.width)
+				{
+					sum += static_cast<Delta>(detail::readBits(m_deltas.data(), bit, info.width));
+					if (offset < sum) break;
+				}
+
+				const std::size_t position = b * kBlockSize + i - 1;
+				return m_dictionary[detail::readBits(m_codes.data(), std::uint64_t(position) * m_codeWidth, m_codeWidth)];
+			}
+
+			// Resolves count keys in one call: out[i] = (*this)[keys[i]]
+			void lookupBatch(const K* keys, std::size_t count, V* out) const
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					out[i] = (*this)[keys[i]];
+				}
+			}
+
+			// Number of boundaries
+			std::size_t size() const { return m_size; }
+			bool empty() const { return m_size == 0; }
+
+			const V& valBegin() const { return m_valBegin; }
+
+			std::size_t distinctValues() const { return m_dictionary.size(); }
+
+			// Bytes of the encoded boundaries: index, packed deltas and codes. The dictionary counts as sizeof(V)
+			// per distinct value, heap owned by the values excluded.
+			std::size_t memoryBytes() const
+			{
+				return m_blockKeys.capacity() * sizeof(K)
+					+ m_blocks.capacity() * sizeof(Block)
+					+ (m_deltas.capacity() + m_codes.capacity()) * sizeof(std::uint64_t)
+					+ m_dictionary.capacity() * sizeof(V);
+			}
+
+		private:
+
+			V m_valBegin;
+			std::size_t m_size;
+
+			std::vector<K> m_blockKeys;
+			std::vector<Block> m_blocks;
+			std::vector<std::uint64_t> m_deltas;
+
+			std::vector<V> m_dictionary;
+			std::vector<std::uint64_t> m_codes;
+			unsigned m_codeWidth = 0;
+	};
+
+	template <typename K, typename V, typename Storage, typename Allocator, typename Stats>
+	CompressedIntervalMap<K, V> compress(const IntervalMap<K, V, Storage, Allocator, Stats>& iMap)
+	{
+		return CompressedIntervalMap<K, V>(iMap);
+	}
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <thread>
+#include <utility>
+
+#include "IntervalMap.hpp"
+
+namespace DS
+{
+	// Single writer, many readers. Readers get wait-free access to an immutable snapshot,
+	// the writer stages changes privately and publishes them as a new snapshot.
+	// Reclamation follows the userspace RCU scheme: readers announce themselves in one of two phase counters,
+	// the writer flips the phase twice after publishing and frees the old snapshot once both phases drained.
+	template <typename K, typename V, typename Storage = FlatStorage>
+	class ConcurrentIntervalMap
+	{
+		public:
+
+			using Snapshot = IntervalMap<K, V, Storage>;
+
+		private:
+
+			// Readers of different threads land on different cache lines
+			static constexpr std::size_t kReaderSlots = 64;
+
+			struct alignas(64) ReaderSlot
+			{
+				std::atomic<std::uint64_t> active[2] = { 0, 0 };
+			};
+
+		public:
+
+			// Pins the snapshot which was current when the guard was created. Keep it short, it delays reclamation.
+			class ReadGuard
+			{
+				public:
+
+					ReadGuard(const ReadGuard&) = delete;
+					ReadGuard& operator=(const ReadGuard&) = delete;
+
+					~ReadGuard()
+					{
+						m_counter.fetch_sub(1, std::memory_order_release);
+					}
+
+				public:
+
+					const Snapshot& operator*() const { return *m_snapshot; }
+					const Snapshot* operator->() const { return m_snapshot; }
+
+				private:
+
+					friend class ConcurrentIntervalMap;
+
+					explicit ReadGuard(const ConcurrentIntervalMap& owner)
+					:
+						m_counter(owner.m_slots[slotIndex()].active[owner.m_phase.load(std::memory_order_seq_cst) & 1])
+					{
+						m_counter.fetch_add(1, std::memory_order_seq_cst);
+						m_snapshot = owner.m_current.load(std::memory_order_seq_cst);
+					}
+
+				private:
+
+					std::atomic<std::uint64_t>& m_counter;
+					const Snapshot* m_snapshot;
+			};
+
+		public:
+
+			ConcurrentIntervalMap()
+			:
+				ConcurrentIntervalMap(V{})
+			{}
+
+			template<typename V_forward>
+			explicit ConcurrentIntervalMap(V_forward&& val)
+			:
+				m_staging(std::forward<V_forward>(val)),
+				m_current(new Snapshot(m_staging))
+			{}
+
+			ConcurrentIntervalMap(const ConcurrentIntervalMap&) = delete;
+			ConcurrentIntervalMap& operator=(const ConcurrentIntervalMap&) = delete;
+
+			// No reader may be active any more
+			~ConcurrentIntervalMap()
+			{
+				delete m_current.load();
+			}
+
+		public: // Readers, any thread
+
+			ReadGuard read() const
+			{
+				return ReadGuard(*this);
+			}
+
+			V operator[](const K& key) const
+			{
+				ReadGuard guard = read();
+				return (*guard)[key];
+			}
+
+		public: // Writer, one thread at a time. Nothing is visible to readers before publish().
+
+			template<typename V_forward>
+			void insert(const K& keyBegin, const K& keyEnd, V_forward&& val)
+			{
+				m_staging.insert(keyBegin, keyEnd, std::forward<V_forward>(val));
+			}
+
+			void insertBatch(std::span<const Interval<K, V>> intervals)
+			{
+				m_staging.insertBatch(intervals);
+			}
+
+			// Content readers will see after the next publish()
+			const Snapshot& staged() const
+			{
+				return m_staging;
+			}
+
+			// Makes the staged content visible. Readers are never blocked, the writer waits for the readers
+			// of the previous snapshot before freeing it.
+			void publish()
+			{
+				const Snapshot* old = m_current.exchange(new Snapshot(m_staging), std::memory_order_seq_cst);
+				synchronize();
+				delete old;
+			}
+
+		private:
+
+			static std::size_t slotIndex()
+			{
+				static thread_local const std::size_t index = std::hash<std::thread::id>{}(std::this_thread::get_id()) % kReaderSlots;
+				return index;
+			}
+
+			// Two flips are needed: a reader may have picked its phase before the first flip
+			// but incremented the counter after the writer checked it
+			void synchronize()
+			{
+				for (int flip = 0; flip < 2; ++flip)
+				{
+					const std::uint64_t drained = m_phase.fetch_add(1, std::memory_order_seq_cst) & 1;
+					for (const auto& slot : m_slots)
+					{
+						while (slot.active[drained].load(std::memory_order_acquire) != 0)
+						{
+							std::this_thread::yield();
+						}
+					}
+				}
+			}
+
+		private:
+
+			Snapshot m_staging;
+			std::atomic<const Snapshot*> m_current;
+			std::atomic<std::uint64_t> m_phase = 0;
+			mutable ReaderSlot m_slots[kReaderSlots];
+	};
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Interval.hpp"
+#include "IntervalMap.hpp"
+#include "MappedFile.hpp"
+
+namespace DS
+{
+	struct CsvOptions
+	{
+		char delimiter = ',';
+		bool skipHeader = false;
+
+		// Unit of parallel parsing, cut at line ends
+		std::size_t chunkBytes = std::size_t(4) << 20;
+
+		// Parsing threads, 0 picks one per core
+		std::size_t threadCount = 0;
+	};
+
+	namespace detail
+	{
+		// Arithmetic fields go through std::from_chars, strings take the field as is
+		template <typename T>
+		bool parseField(const char* first, const char* last, T& out)
+		{
+			if constexpr (std::is_same_v<T, std::string>)
+			{
+				out.assign(first, last);
+				return true;
+			}
+			else
+			{
+				static_assert(std::is_arithmetic_v<T>, "CSV fields have to be arithmetic or std::string");
+
+				// from_chars rejects the '+' sign of "+5", which some exporters write
+				if (first != last && *first == '+') ++first;
+				const auto [ptr, ec] = std::from_chars(first, last, out);
+				return ec == std::errc() && ptr == last;
+			}
+		}
+
+		// Lines "begin<d>end<d>value" of [first, last) in file order. Empty lines are skipped,
+		// "\r\n" ends are accepted, and the value is everything after the second delimiter.
+		template <typename K, typename V>
+		std::vector<Interval<K, V>> parseCsvChunk(const char* first, const char* last, const char* fileBegin, char delimiter)
+		{
+			std::vector<Interval<K, V>> intervals;
+			intervals.reserve(static_cast<std::size_t>(last - first) / 16);
+
+			while (first < last)
+			{
+				const char* lineEnd = static_cast<const char*>(std::memchr(first, '\n', static_cast<std::size_t>(last - first)));
+				if (!lineEnd) lineEnd = last;
+				const char* next = (lineEnd == last) ? last : lineEnd + 1;
+				if (lineEnd != first && lineEnd[-1] == '\r') --lineEnd;
+
+				if (lineEnd != first)
+				{
+					const char* sep1 = std::find(first, lineEnd, delimiter);
+					const char* sep2 = (sep1 == lineEnd) ? lineEnd : std::find(sep1 + 1, lineEnd, delimiter);
+
+					Interval<K, V> interval;
+					if (sep2 == lineEnd
+						|| !parseField(first, sep1, interval.keyBegin)
+						|| !parseField(sep1 + 1, sep2, interval.keyEnd)
+						|| !parseField(sep2 + 1, lineEnd, interval.val))
+					{
+						throw std::runtime_error("Malformed CSV line at byte " + std::to_string(first - fileBegin) + ": " + std::string(first, lineEnd));
+					}
+					intervals.push_back(std::move(interval));
+				}
+				first = next;
+			}
+			return intervals;
+		}
+
+		// Chunk ends: every chunk but the last ends right after a '\n'
+		inline std::vector<const char*> splitAtLines(const char* first, const char* last, std::size_t chunkBytes)
+		{
+			std::vector<const char*> ends;
+			while (first < last)
+			{
+				const char* end = (static_cast<std::size_t>(last - first) <= chunkBytes) ? last : first + chunkBytes;
+				if (end != last)
+				{
+					const char* lineEnd = static_cast<const char*>(std::memchr(end, '\n', static_cast<std::size_t>(last - end)));
+					end = lineEnd ? lineEnd + 1 : last;
+				}
+				ends.push_back(end);
+				first = end;
+			}
+			return ends;
+		}
+	}
+
+	// Inserts the intervals of a "begin,end,value" text file into iMap, with the result of calling insert()
+	// for every line in file order. The file is memory mapped and cut into chunks at line ends; chunks are parsed
+	// in parallel with std::from_chars, at most threadCount + 1 at a time, while the calling thread collects the
+	// finished ones in file order. The whole file is then applied at once: assign() into an empty map, one
+	// insertBatch() otherwise. Applying chunk by chunk would rebuild a contiguous storage once per chunk.
+	// Throws std::runtime_error on unreadable files and malformed lines; iMap is left unchanged then.
+	// Returns the number of intervals read.
+	template <typename K, typename V, typename Storage, typename Allocator, typename Stats>
+	std::size_t loadCsv(IntervalMap<K, V, Storage, Allocator, Stats>& iMap, const std::string& path, const CsvOptions& options = {})
+	{
+		const detail::MappedFile file(path);
+		if (file.size() == 0) return 0;
+
+		const char* const fileBegin = reinterpret_cast<const char*>(file.data());
+		const char* first = fileBegin;
+		const char* const last = fileBegin + file.size();
+
+		if (options.skipHeader)
+		{
+			const char* lineEnd = static_cast<const char*>(std::memchr(first, '\n', file.size()));
+			first = lineEnd ? lineEnd + 1 : last;
+		}
+
+		const std::vector<const char*> ends = detail::splitAtLines(first, last, std::max<std::size_t>(options.chunkBytes, 1));
+		const std::size_t threadCount = (options.threadCount != 0)
+			? options.threadCount
+			: std::max(1u, std::thread::hardware_concurrency());
+		const std::size_t window = threadCount + 1;
+
+		std::vector<Interval<K, V>> intervals;
+		std::size_t launched = 0;
+		std::deque<std::future<std::vector<Interval<K, V>>>> inFlight;
+		const char* chunkBegin = first;
+		auto launch = [&]()
+		{
+			const char* begin = chunkBegin;
+			const char* end = ends[launched++];
+			chunkBegin = end;
+			inFlight.push_back(std::async(std::launch::async, [=, delimiter = options.delimiter]()
+			{
+				return detail::parseCsvChunk<K, V>(begin, end, fileBegin, delimiter);
+			}));
+		};
+
+		while (launched < ends.size() && inFlight.size() < window)
+		{
+			launch();
+		}
+		while (!inFlight.empty())
+		{
+			std::vector<Interval<K, V>> chunk = inFlight.front().get();
+			inFlight.pop_front();
+			if (launched < ends.size())
+			{
+				launch();
+			}
+
+			if (intervals.empty())
+			{
+				intervals = std::move(chunk);
+			}
+			else
+			{
+				intervals.insert(intervals.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+			}
+		}
+
+		if (iMap.getMap().empty())
+		{
+			iMap.assign(std::make_move_iterator(intervals.begin()), std::make_move_iterator(intervals.end()));
+		}
+		else
+		{
+			iMap.insertBatch(std::span<const Interval<K, V>>(intervals));
+		}
+		return intervals.size();
+	}
+}
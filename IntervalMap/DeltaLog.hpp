@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace DS
+{
+	// Append-only journal of the boundary mutations of an IntervalMap, in the order they were made.
+	// A replica which held the same boundaries as the source when recording started reaches the same
+	// boundaries again through IntervalMap::applyDelta(). Its size follows the number of boundaries an
+	// update touched, not the size of the map: an insert() records at most four operations.
+	template <typename K, typename V>
+	class DeltaLog
+	{
+		public:
+
+			enum class Kind : std::uint8_t
+			{
+				Set,   // Adds the boundary key, or overwrites its value; the value is the next one of values()
+				Erase, // Removes every boundary of [key, last], last being the next one of eraseLasts()
+				Clear  // Removes every boundary
+			};
+
+			// Operands beyond the key live in values() and eraseLasts(), so an operation costs the same whatever its kind
+			struct Op
+			{
+				Kind kind;
+				K key;
+			};
+
+		public:
+
+			void recordSet(const K& key, const V& val)
+			{
+				m_ops.push_back({ Kind::Set, key });
+				m_values.push_back(val);
+			}
+
+			void recordErase(const K& first, const K& last)
+			{
+				m_ops.push_back({ Kind::Erase, first });
+				m_eraseLasts.push_back(last);
+			}
+
+			void recordClear()
+			{
+				m_ops.push_back({ Kind::Clear, K{} });
+			}
+
+		public:
+
+			std::span<const Op> ops() const { return m_ops; }
+
+			// Values of the Set operations, in the same order
+			std::span<const V> values() const { return m_values; }
+
+			// Last keys of the Erase operations, in the same order
+			std::span<const K> eraseLasts() const { return m_eraseLasts; }
+
+			std::size_t size() const { return m_ops.size(); }
+			bool empty() const { return m_ops.empty(); }
+
+			// Drops the recorded operations, e.g. once every replica received them
+			void clear()
+			{
+				m_ops.clear();
+				m_values.clear();
+				m_eraseLasts.clear();
+			}
+
+		private:
+
+			std::vector<Op> m_ops;
+			std::vector<V> m_values;
+			std::vector<K> m_eraseLasts;
+	};
+}
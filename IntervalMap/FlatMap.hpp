@@ -0,0 +1,284 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "SmallVector.hpp"
+
+namespace DS
+{
+	// Sorted-array associative container with the subset of the std::map interface IntervalMap relies on.
+	// Keys and values live in two separate contiguous arrays, so searches only touch the key array.
+	// Like std::vector (and unlike std::map) every modification invalidates all iterators.
+	// Allocator is given for std::pair<const K, V> like for std::map and is rebound for both arrays.
+	// With an InlineCapacity both arrays keep that many boundaries inside the object before allocating.
+	template <typename K, typename V, typename Allocator = std::allocator<std::pair<const K, V>>, std::size_t InlineCapacity = 0>
+	class FlatMap
+	{
+		private:
+
+			using KeyAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<K>;
+			using ValAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<V>;
+
+			template <typename T, typename A>
+			using Array = std::conditional_t<InlineCapacity == 0, std::vector<T, A>, SmallVector<T, std::max<std::size_t>(InlineCapacity, 1), A>>;
+
+			using KeyArray = Array<K, KeyAllocator>;
+			using ValArray = Array<V, ValAllocator>;
+
+			// A few dozen arithmetic keys are counted faster than binary searched: the loop has no
+			// data dependent branch and vectorizes. Past the inline capacity the binary search takes over.
+			static constexpr bool kLinearSearch = InlineCapacity > 0 && InlineCapacity <= 64 && std::is_arithmetic_v<K>;
+
+			template <bool IsConst>
+			class Iterator
+			{
+				private:
+
+					using ValuePtr = std::conditional_t<IsConst, const V*, V*>;
+					using ValueRef = std::conditional_t<IsConst, const V&, V&>;
+
+				public:
+
+					using iterator_category = std::random_access_iterator_tag;
+					using difference_type = std::ptrdiff_t;
+					using value_type = std::pair<K, V>;
+					using reference = std::pair<const K&, ValueRef>;
+
+					// Elements are split between two arrays, so '->' has to go through a temporary pair
+					struct pointer
+					{
+						reference ref;
+						const reference* operator->() const { return &ref; }
+					};
+
+				public:
+
+					Iterator() = default;
+
+					Iterator(const K* key, ValuePtr val)
+					:
+						m_key(key),
+						m_val(val)
+					{}
+
+					// iterator -> const_iterator
+					template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+					Iterator(const Iterator<OtherConst>& other)
+					:
+						m_key(other.m_key),
+						m_val(other.m_val)
+					{}
+
+				public:
+
+					reference operator*() const { return { *m_key, *m_val }; }
+					pointer operator->() const { return { **this }; }
+					reference operator[](difference_type n) const { return *(*this + n); }
+
+					Iterator& operator++() { ++m_key; ++m_val; return *this; }
+					Iterator& operator--() { --m_key; --m_val; return *this; }
+					Iterator operator++(int) { Iterator tmp = *this; ++*this; return tmp; }
+					Iterator operator--(int) { Iterator tmp = *this; --*this; return tmp; }
+
+					Iterator& operator+=(difference_type n) { m_key += n; m_val += n; return *this; }
+					Iterator& operator-=(difference_type n) { m_key -= n; m_val -= n; return *this; }
+
+					friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+					friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+					friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+					friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) { return lhs.m_key - rhs.m_key; }
+
+					friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs.m_key == rhs.m_key; }
+					friend bool operator!=(const Iterator& lhs, const Iterator& rhs) { return lhs.m_key != rhs.m_key; }
+					friend bool operator<(const Iterator& lhs, const Iterator& rhs) { return lhs.m_key < rhs.m_key; }
+					friend bool operator>(const Iterator& lhs, const Iterator& rhs) { return lhs.m_key > rhs.m_key; }
+					friend bool operator<=(const Iterator& lhs, const Iterator& rhs) { return lhs.m_key <= rhs.m_key; }
+					friend bool operator>=(const Iterator& lhs, const Iterator& rhs) { return lhs.m_key >= rhs.m_key; }
+
+				private:
+
+					template <bool> friend class Iterator;
+					friend class FlatMap;
+
+					const K* m_key = nullptr;
+					ValuePtr m_val = nullptr;
+			};
+
+		public:
+
+			using key_type = K;
+			using mapped_type = V;
+			using value_type = std::pair<K, V>;
+			using size_type = std::size_t;
+			using key_compare = std::less<K>;
+			using allocator_type = Allocator;
+			using iterator = Iterator<false>;
+			using const_iterator = Iterator<true>;
+
+		public:
+
+			FlatMap() = default;
+
+			explicit FlatMap(const Allocator& alloc)
+			:
+				m_keys(KeyAllocator(alloc)),
+				m_vals(ValAllocator(alloc))
+			{}
+
+			allocator_type get_allocator() const { return allocator_type(m_keys.get_allocator()); }
+
+		public:
+
+			iterator begin() { return { m_keys.data(), m_vals.data() }; }
+			iterator end() { return begin() + size(); }
+			const_iterator begin() const { return { m_keys.data(), m_vals.data() }; }
+			const_iterator end() const { return begin() + size(); }
+
+			bool empty() const { return m_keys.empty(); }
+			size_type size() const { return m_keys.size(); }
+			key_compare key_comp() const { return {}; }
+
+			void clear()
+			{
+				m_keys.clear();
+				m_vals.clear();
+			}
+
+			void reserve(size_type capacity)
+			{
+				m_keys.reserve(capacity);
+				m_vals.reserve(capacity);
+			}
+
+			// Contiguous views used by search-heavy callers
+			const KeyArray& keys() const { return m_keys; }
+			const ValArray& values() const { return m_vals; }
+
+		public:
+
+			iterator lower_bound(const K& key) { return begin() + search<false>(key); }
+			iterator upper_bound(const K& key) { return begin() + search<true>(key); }
+			const_iterator lower_bound(const K& key) const { return begin() + search<false>(key); }
+			const_iterator upper_bound(const K& key) const { return begin() + search<true>(key); }
+
+			iterator find(const K& key)
+			{
+				auto it = lower_bound(key);
+				return (it != end() && !(key < it->first)) ? it : end();
+			}
+
+			const_iterator find(const K& key) const
+			{
+				auto it = lower_bound(key);
+				return (it != end() && !(key < it->first)) ? it : end();
+			}
+
+			// The hint is trusted if it is the correct position for the key, otherwise the position is searched for
+			template <typename K_forward, typename V_forward>
+			iterator emplace_hint(const_iterator hint, K_forward&& key, V_forward&& val)
+			{
+				const size_type pos = positionFor(hint, key);
+				if (pos < size() && !(key < m_keys[pos]))
+				{
+					return begin() + pos; // Same semantic as std::map: existing key is left untouched
+				}
+
+				return insertAt(pos, std::forward<K_forward>(key), std::forward<V_forward>(val));
+			}
+
+			template <typename V_forward>
+			iterator insert_or_assign(const_iterator hint, const K& key, V_forward&& val)
+			{
+				const size_type pos = positionFor(hint, key);
+				if (pos < size() && !(key < m_keys[pos]))
+				{
+					m_vals[pos] = std::forward<V_forward>(val);
+					return begin() + pos;
+				}
+
+				return insertAt(pos, key, std::forward<V_forward>(val));
+			}
+
+			iterator erase(const_iterator first, const_iterator last)
+			{
+				const size_type from = indexOf(first);
+				const size_type to = indexOf(last);
+				m_keys.erase(m_keys.begin() + from, m_keys.begin() + to);
+				m_vals.erase(m_vals.begin() + from, m_vals.begin() + to);
+				return begin() + from;
+			}
+
+			iterator erase(const_iterator pos)
+			{
+				return erase(pos, std::next(pos));
+			}
+
+		private:
+
+			// Number of keys less than key, or not greater than key when Upper
+			template <bool Upper>
+			size_type search(const K& key) const
+			{
+				if constexpr (kLinearSearch)
+				{
+					if (size() <= InlineCapacity)
+					{
+						const K* keys = m_keys.data();
+						size_type count = 0;
+						for (size_type i = 0; i < size(); ++i)
+						{
+							count += Upper ? !(key < keys[i]) : keys[i] < key;
+						}
+						return count;
+					}
+				}
+
+				const auto it = Upper
+					? std::upper_bound(m_keys.begin(), m_keys.end(), key)
+					: std::lower_bound(m_keys.begin(), m_keys.end(), key);
+				return static_cast<size_type>(it - m_keys.begin());
+			}
+
+			// Strong guarantee like std::map: when the value cannot be inserted, the key is taken out again
+			// and both arrays keep the same size
+			template <typename K_forward, typename V_forward>
+			iterator insertAt(size_type pos, K_forward&& key, V_forward&& val)
+			{
+				m_keys.insert(m_keys.begin() + pos, std::forward<K_forward>(key));
+				try
+				{
+					m_vals.insert(m_vals.begin() + pos, std::forward<V_forward>(val));
+				}
+				catch (...)
+				{
+					m_keys.erase(m_keys.begin() + pos, m_keys.begin() + pos + 1);
+					throw;
+				}
+				return begin() + pos;
+			}
+
+			size_type indexOf(const_iterator it) const { return static_cast<size_type>(it.m_key - m_keys.data()); }
+
+			size_type positionFor(const_iterator hint, const K& key) const
+			{
+				const size_type pos = indexOf(hint);
+				if ((pos == 0 || m_keys[pos - 1] < key) && (pos == size() || !(m_keys[pos] < key)))
+				{
+					return pos;
+				}
+				return search<false>(key);
+			}
+
+		private:
+
+			KeyArray m_keys;
+			ValArray m_vals;
+	};
+}
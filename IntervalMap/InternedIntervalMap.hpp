@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "IntervalMap.hpp"
+
+namespace DS
+{
+	// Interval map for heavyweight values shared by many intervals. Every distinct value is stored once in a dictionary,
+	// boundaries only hold integer ids: copies in insert() and the equality checks of the canonical form are integer ones
+	// and memory grows with the number of distinct values instead of the number of boundaries.
+	// Values stay in the dictionary until compact() drops the unreferenced ones.
+	template <typename K, typename V, typename Storage = TreeStorage, typename Id = std::uint32_t, typename Hash = std::hash<V>>
+	class InternedIntervalMap
+	{
+		private:
+
+			struct RefHash
+			{
+				std::size_t operator()(const std::reference_wrapper<const V>& val) const { return Hash{}(val.get()); }
+			};
+
+			struct RefEqual
+			{
+				bool operator()(const std::reference_wrapper<const V>& lhs, const std::reference_wrapper<const V>& rhs) const { return lhs.get() == rhs.get(); }
+			};
+
+		public:
+
+			using IdMap = IntervalMap<K, Id, Storage>;
+
+		public:
+
+			InternedIntervalMap()
+			:
+				InternedIntervalMap(V{})
+			{}
+
+			template<typename V_forward>
+				requires (!std::is_same_v<std::remove_cvref_t<V_forward>, InternedIntervalMap>)
+			InternedIntervalMap(V_forward&& val)
+			:
+				m_ids(kValBeginId)
+			{
+				intern(std::forward<V_forward>(val));
+			}
+
+			// The dictionary index refers to the values of this object, a copy has to rebuild it
+			InternedIntervalMap(const InternedIntervalMap& other)
+			:
+				m_ids(other.m_ids),
+				m_values(other.m_values)
+			{
+				reindex();
+			}
+
+			InternedIntervalMap& operator=(const InternedIntervalMap& other)
+			{
+				if (this != &other)
+				{
+					m_ids = other.m_ids;
+					m_values = other.m_values;
+					reindex();
+				}
+				return *this;
+			}
+
+			// Deque elements do not move with the container, the index stays valid
+			InternedIntervalMap(InternedIntervalMap&&) = default;
+			InternedIntervalMap& operator=(InternedIntervalMap&&) = default;
+
+		public:
+
+			// Id of val, added to the dictionary if it is new. Lets callers hash a value once and insert it many times.
+			// Anything else than a V is converted once, then looked up and moved in.
+			template <typename V_forward>
+			Id intern(V_forward&& val)
+			{
+				if constexpr (std::is_same_v<std::remove_cvref_t<V_forward>, V>)
+				{
+					if (auto it = m_index.find(std::cref(val)); it != m_index.end())
+					{
+						return it->second;
+					}
+					return add(std::forward<V_forward>(val));
+				}
+				else
+				{
+					return intern(V(std::forward<V_forward>(val)));
+				}
+			}
+
+			template<typename V_forward>
+			void insert(const K& keyBegin, const K& keyEnd, V_forward&& val)
+			{
+				if (!(keyBegin < keyEnd)) return;
+
+				m_ids.insert(keyBegin, keyEnd, intern(std::forward<V_forward>(val)));
+			}
+
+			// id has to come from intern() of this map (and survive compact() only through its return value)
+			void insertId(const K& keyBegin, const K& keyEnd, Id id)
+			{
+				assert(id < m_values.size());
+				m_ids.insert(keyBegin, keyEnd, id);
+			}
+
+			V const& operator[](K const& key) const
+			{
+				return m_values[m_ids[key]];
+			}
+
+			const V& valueOf(Id id) const
+			{
+				return m_values[id];
+			}
+
+			const V& valBegin() const
+			{
+				return m_values[kValBeginId];
+			}
+
+			// Boundaries as ids, valueOf() turns them back into values
+			const IdMap& ids() const
+			{
+				return m_ids;
+			}
+
+			std::size_t distinctValues() const
+			{
+				return m_values.size();
+			}
+
+			// Drops the values no boundary refers to any more and renumbers the rest, order preserved.
+			// Ids obtained before are invalidated, the returned table maps them to the new ones (or to kDropped).
+			std::vector<Id> compact()
+			{
+				std::vector<Id> remap(m_values.size(), kDropped);
+				remap[kValBeginId] = kValBeginId;
+				for (const auto& [key, id] : m_ids.getMap())
+				{
+					remap[id] = id;
+				}
+
+				std::deque<V> kept;
+				for (std::size_t id = 0; id < m_values.size(); ++id)
+				{
+					if (remap[id] != kDropped)
+					{
+						remap[id] = static_cast<Id>(kept.size());
+						kept.push_back(std::move(m_values[id]));
+					}
+				}
+				m_values = std::move(kept);
+				reindex();
+
+				// Rebuilt through assignSorted(), so the id map bumps its version and journals like any other write
+				std::vector<Interval<K, Id>> intervals;
+				intervals.reserve(m_ids.getMap().size());
+				for (const auto& interval : m_ids.intervals())
+				{
+					intervals.push_back({ interval.keyBegin, interval.keyEnd, remap[interval.val] });
+				}
+				m_ids.assignSorted(intervals.begin(), intervals.end());
+				return remap;
+			}
+
+		public:
+
+			static constexpr Id kValBeginId = 0;
+			static constexpr Id kDropped = std::numeric_limits<Id>::max();
+
+		private:
+
+			template <typename V_forward>
+			Id add(V_forward&& val)
+			{
+				assert(m_values.size() <= std::numeric_limits<Id>::max());
+				const Id id = static_cast<Id>(m_values.size());
+				m_values.push_back(std::forward<V_forward>(val));
+				m_index.emplace(std::cref(m_values.back()), id);
+				return id;
+			}
+
+			void reindex()
+			{
+				m_index.clear();
+				for (std::size_t id = 0; id < m_values.size(); ++id)
+				{
+					m_index.emplace(std::cref(m_values[id]), static_cast<Id>(id));
+				}
+			}
+
+		private:
+
+			IdMap m_ids;
+			std::deque<V> m_values;
+			std::unordered_map<std::reference_wrapper<const V>, Id, RefHash, RefEqual> m_index;
+	};
+}
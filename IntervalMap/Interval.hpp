@@ -0,0 +1,22 @@
+#pragma once
+
+namespace DS
+{
+	// Half-open interval [keyBegin, keyEnd) mapped to val, the unit of the bulk operations
+	template <typename K, typename V>
+	struct Interval
+	{
+		K keyBegin;
+		K keyEnd;
+		V val;
+	};
+
+	// Non-owning [keyBegin, keyEnd) -> val, refers to data of the map (or query bounds) it came from
+	template <typename K, typename V>
+	struct IntervalView
+	{
+		const K& keyBegin;
+		const K& keyEnd;
+		const V& val;
+	};
+}
@@ -2,3 +2,4 @@
 
 // Workaround in order to have static lib
 template class DS::IntervalMap<int, int>;
+template class DS::IntervalMap<int, int, DS::FlatStorage>;
@@ -1,15 +1,141 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <map>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "BatchSearch.hpp"
+#include "DeltaLog.hpp"
+#include "FlatMap.hpp"
+#include "Interval.hpp"
+#include "LastWriterWins.hpp"
+#include "Platform.hpp"
+#include "Stats.hpp"
 
 //debug includes
 #include <iostream>
 
 namespace DS
 {
-	template <typename K, typename V>
+	// Storage policies. Each one names the ordered container which keeps the interval boundaries.
+	// The allocator is always given for std::pair<const K, V>, containers rebind it as they need.
+
+	// Red-black tree: cheap insertion anywhere, one heap node per boundary
+	struct TreeStorage
+	{
+		template <typename K, typename V, typename Allocator>
+		using Container = std::map<K, V, std::less<K>, Allocator>;
+	};
+
+	// Sorted contiguous arrays: cache friendly lookups, insertion shifts the tail
+	struct FlatStorage
+	{
+		template <typename K, typename V, typename Allocator>
+		using Container = FlatMap<K, V, Allocator>;
+	};
+
+	// Sorted arrays inside the map object up to N boundaries: no allocation at all for small maps,
+	// and linear search for arithmetic keys. Past N the arrays move to the heap and behave like FlatStorage.
+	template <std::size_t N>
+	struct SmallStorage
+	{
+		template <typename K, typename V, typename Allocator>
+		using Container = FlatMap<K, V, Allocator, N>;
+	};
+
+	namespace detail
+	{
+		// Modification counter of one map. It only ever grows while the object lives: assignments replace
+		// the content, so they take a value the target never had, and the source of a move is bumped as well.
+		// A cache which saw some version can therefore trust everything it remembers while the version stays.
+		class Version
+		{
+			public:
+
+				Version() = default;
+
+				Version(const Version& other)
+				:
+					m_value(other.m_value)
+				{}
+
+				Version(Version&& other) noexcept
+				:
+					m_value(other.m_value)
+				{
+					other.bump();
+				}
+
+				Version& operator=(const Version& other)
+				{
+					m_value = std::max(m_value, other.m_value) + 1;
+					return *this;
+				}
+
+				Version& operator=(Version&& other) noexcept
+				{
+					m_value = std::max(m_value, other.m_value) + 1;
+					other.bump();
+					return *this;
+				}
+
+			public:
+
+				void bump() { ++m_value; }
+
+				std::uint64_t value() const { return m_value; }
+
+			private:
+
+				std::uint64_t m_value = 0;
+		};
+
+		// Pointer tied to one object: copies and moves of the owner start without it, assignments keep the target's
+		template <typename T>
+		class LocalPtr
+		{
+			public:
+
+				LocalPtr() = default;
+				LocalPtr(const LocalPtr&) {}
+				LocalPtr& operator=(const LocalPtr&) { return *this; }
+
+			public:
+
+				void reset(T* ptr) { m_ptr = ptr; }
+
+				T* get() const { return m_ptr; }
+				T* operator->() const { return m_ptr; }
+				explicit operator bool() const { return m_ptr != nullptr; }
+
+			private:
+
+				T* m_ptr = nullptr;
+		};
+	}
+
+	// Stats is a policy of hooks called by insert() and operator[], NoStats compiles them away
+	template <typename K, typename V, typename Storage = TreeStorage, typename Allocator = std::allocator<std::pair<const K, V>>, typename Stats = NoStats>
 	class IntervalMap // add commented docs on what is expected from K and V
 	{
+		public:
+
+			using MapType = typename Storage::template Container<K, V, Allocator>;
+			using AllocatorType = Allocator;
+
 		public:
 
 			IntervalMap() //implement 5 rule
@@ -18,49 +144,354 @@ namespace DS
 			{}
 
 			template<typename V_forward>
+				requires (!std::is_same_v<std::remove_cvref_t<V_forward>, IntervalMap>) // Copying a non-const map is not a value
 			IntervalMap(V_forward&& val)
 			:
 				m_valBegin(std::forward<V_forward>(val))
 			{}
 
+			// Every boundary is allocated through alloc
+			template<typename V_forward>
+			IntervalMap(V_forward&& val, const Allocator& alloc)
+			:
+				m_valBegin(std::forward<V_forward>(val)),
+				m_map(alloc)
+			{}
+
 		public:
 
 			template<typename V_forward>
 			void insert(const K& keyBegin, const K& keyEnd, V_forward&& val)
 			{
+				[[maybe_unused]] const auto sample = m_stats.onInsert();
 				if (!(keyBegin < keyEnd)) return;
 
-				auto itBegin = m_map.lower_bound(keyBegin);
-				auto itEnd = m_map.upper_bound(keyEnd);
+				insertAt(m_map.lower_bound(keyBegin), m_map.upper_bound(keyEnd), keyBegin, keyEnd, std::forward<V_forward>(val));
+			}
+
+			// Inserts through a finger: remembers where the previous insertion ended and searches from there.
+			// Appends in key order cost amortized O(1), nearby updates O(log d) on flat storages (d boundaries away);
+			// tree storages walk a few steps from the finger before falling back to a full search.
+			// Any modification of the map not made through this inserter invalidates it.
+			class Inserter
+			{
+				public:
+
+					explicit Inserter(IntervalMap& iMap)
+					:
+						m_iMap(iMap),
+						m_finger(iMap.m_map.begin())
+					{}
+
+				public:
+
+					template<typename V_forward>
+					void insert(const K& keyBegin, const K& keyEnd, V_forward&& val)
+					{
+						[[maybe_unused]] const auto sample = m_iMap.m_stats.onInsert();
+						if (!(keyBegin < keyEnd)) return;
+
+						auto itBegin = m_iMap.template seek<false>(m_finger, keyBegin);
+						auto itEnd = m_iMap.template seek<true>(itBegin, keyEnd);
+						m_finger = m_iMap.insertAt(itBegin, itEnd, keyBegin, keyEnd, std::forward<V_forward>(val));
+					}
 
-				// Saving right overlaping value before map modifying (don't like it btw...)
-				V prevEndVal = (itEnd != m_map.end() && itEnd != m_map.begin())
-					? std::prev(itEnd)->second
-					: m_valBegin;
+				private:
 
-				const bool isSameValAsPrevEnd = (val == prevEndVal);
-				const bool isSameValAsPrevBegin = (m_map.empty() || itBegin == m_map.begin())
-					? val == m_valBegin
-					: val == std::prev(itBegin)->second;
+					IntervalMap& m_iMap;
+					typename MapType::iterator m_finger;
+			};
 
-				// Left overlap handling
-				if (!isSameValAsPrevBegin)
+			Inserter inserter()
+			{
+				return Inserter(*this);
+			}
+
+		private:
+
+			// Core of insert(): itBegin and itEnd have to be lower_bound(keyBegin) and upper_bound(keyEnd).
+			// Returns the first boundary not less than keyEnd, which is where a following append starts searching.
+			// V is only copied when the value before keyBegin also continues after keyEnd, val is moved at most once,
+			// and compared at most three times (once when no boundary lies in [keyBegin, keyEnd], three times only when
+			// a boundary sits at keyBegin and nothing else changes). The version only moves on when the map changes.
+			template<typename V_forward>
+			typename MapType::iterator insertAt(typename MapType::iterator itBegin, typename MapType::iterator itEnd, const K& keyBegin, const K& keyEnd, V_forward&& val)
+			{
+				const V& prevBeginVal = (itBegin == m_map.begin())
+					? m_valBegin
+					: std::prev(itBegin)->second;
+				const bool isSameValAsPrevBegin = (val == prevBeginVal);
+
+				// No boundary inside: the value at keyEnd is the one before keyBegin, which has to stay there
+				if (itBegin == itEnd)
 				{
-					itBegin = std::next(m_map.insert_or_assign(itBegin, keyBegin, std::forward<V_forward>(val)));
+					if (isSameValAsPrevBegin) return itEnd;
+
+					m_version.bump();
+					if (m_journal)
+					{
+						m_journal->recordSet(keyEnd, prevBeginVal);
+						m_journal->recordSet(keyBegin, val);
+					}
+					m_stats.onBoundariesCreated(2);
+					auto itKeyEnd = m_map.emplace_hint(itEnd, keyEnd, prevBeginVal);
+					return std::next(m_map.emplace_hint(itKeyEnd, keyBegin, std::forward<V_forward>(val)));
 				}
 
-				// Right overlap handling
+				// Every boundary in [keyBegin, keyEnd] is redundant after the insertion. The last one carries the value
+				// which continues at keyEnd and moves there; a boundary already at keyBegin or keyEnd is kept in place.
+				const auto itLast = std::prev(itEnd);
+				const bool isSameValAsPrevEnd = (val == itLast->second);
+
+				auto itEraseEnd = itEnd;
+				std::optional<V> prevEndVal;
+				bool isChanged = false;
 				if (!isSameValAsPrevEnd)
 				{
-					itEnd = m_map.insert_or_assign(itEnd, keyEnd, std::move(prevEndVal));
+					if (!(itLast->first < keyEnd))
+					{
+						itEraseEnd = itLast;
+					}
+					else if constexpr (requires { m_map.extract(itLast); })
+					{
+						// Node storages relocate the node itself: no allocation and no V move
+						isChanged = true;
+						if (m_journal)
+						{
+							m_journal->recordErase(itLast->first, itLast->first);
+							m_journal->recordSet(keyEnd, itLast->second);
+						}
+						auto node = m_map.extract(itLast);
+						node.key() = keyEnd;
+						itEraseEnd = m_map.insert(itEnd, std::move(node));
+						m_stats.onBoundariesErased(1);
+						m_stats.onBoundariesCreated(1);
+						if (itBegin == itLast) itBegin = itEraseEnd;
+					}
+					else
+					{
+						isChanged = true;
+						prevEndVal.emplace(std::move(itLast->second));
+					}
 				}
 
-				// Internal overlaps handling
-				if (itBegin != m_map.end() &&
-					(itEnd == m_map.end() || m_map.key_comp()(itBegin->first, itEnd->first)))
+				// The boundary at keyBegin takes val. When nothing else changes it may hold val already: only then
+				// the values are compared, a repeated insert leaves the map and its version untouched.
+				bool isBeginReused = false;
+				if (!isSameValAsPrevBegin && itBegin != itEraseEnd && !(keyBegin < itBegin->first))
 				{
-					m_map.erase(itBegin, itEnd);
+					if (isChanged || std::next(itBegin) != itEraseEnd || !(itBegin->second == val))
+					{
+						isChanged = true;
+						if (m_journal) m_journal->recordSet(keyBegin, val);
+						itBegin->second = std::forward<V_forward>(val);
+					}
+					++itBegin;
+					isBeginReused = true;
 				}
+
+				if (isChanged || itBegin != itEraseEnd || !(isSameValAsPrevBegin || isBeginReused))
+				{
+					m_version.bump();
+				}
+
+				if constexpr (Stats::kEnabled)
+				{
+					m_stats.onBoundariesErased(static_cast<std::size_t>(std::distance(itBegin, itEraseEnd)));
+				}
+				if (m_journal && itBegin != itEraseEnd)
+				{
+					m_journal->recordErase(itBegin->first, std::prev(itEraseEnd)->first);
+				}
+
+				// Erasing first keeps the hint valid for storages which invalidate iterators on insertion
+				auto itHint = m_map.erase(itBegin, itEraseEnd);
+				if (prevEndVal)
+				{
+					if (m_journal) m_journal->recordSet(keyEnd, *prevEndVal);
+					m_stats.onBoundariesCreated(1);
+					itHint = m_map.emplace_hint(itHint, keyEnd, std::move(*prevEndVal));
+				}
+
+				if (!isSameValAsPrevBegin && !isBeginReused)
+				{
+					if (m_journal) m_journal->recordSet(keyBegin, val);
+					m_stats.onBoundariesCreated(1);
+					return std::next(m_map.emplace_hint(itHint, keyBegin, std::forward<V_forward>(val)));
+				}
+				return itHint;
+			}
+
+			// Finger search for lower_bound(key), or upper_bound(key) when Upper
+			template <bool Upper>
+			typename MapType::iterator seek(typename MapType::iterator finger, const K& key)
+			{
+				using Category = typename std::iterator_traits<typename MapType::iterator>::iterator_category;
+
+				// Boundaries before the result
+				auto isBefore = [&key](const auto& boundary) { return Upper ? !(key < boundary.first) : boundary.first < key; };
+
+				if constexpr (std::is_base_of_v<std::random_access_iterator_tag, Category>)
+				{
+					// Exponential search away from the finger brackets the result in [lo, hi], then a binary search
+					const auto first = m_map.begin();
+					const std::ptrdiff_t size = m_map.end() - first;
+					std::ptrdiff_t lo = finger - first;
+					std::ptrdiff_t hi = lo;
+					std::ptrdiff_t step = 1;
+
+					if (lo < size && isBefore(first[lo]))
+					{
+						++lo;
+						while (lo + step - 1 < size && isBefore(first[lo + step - 1]))
+						{
+							lo += step;
+							step *= 2;
+						}
+						hi = std::min(lo + step - 1, size);
+					}
+					else
+					{
+						while (hi - step >= 0 && !isBefore(first[hi - step]))
+						{
+							hi -= step;
+							step *= 2;
+						}
+						lo = std::max<std::ptrdiff_t>(hi - step + 1, 0);
+					}
+					return std::partition_point(first + lo, first + hi, isBefore);
+				}
+				else
+				{
+					// No O(log d) finger search without parent links: a few steps, then a search from the root
+					constexpr int kFingerSteps = 8;
+
+					auto it = finger;
+					if (it != m_map.end() && isBefore(*it))
+					{
+						for (int i = 0; i < kFingerSteps; ++i)
+						{
+							if (++it == m_map.end() || !isBefore(*it)) return it;
+						}
+					}
+					else
+					{
+						for (int i = 0; i < kFingerSteps; ++i)
+						{
+							if (it == m_map.begin() || isBefore(*std::prev(it))) return it;
+							--it;
+						}
+					}
+					return Upper ? m_map.upper_bound(key) : m_map.lower_bound(key);
+				}
+			}
+
+		public:
+
+			// Replaces the whole content by intervals which have to be sorted and non-overlapping.
+			// One linear pass, adjacent equal values are merged the same way insert() does.
+			template <typename InputIt>
+			void assignSorted(InputIt first, InputIt last)
+			{
+				using Category = typename std::iterator_traits<InputIt>::iterator_category;
+
+				m_version.bump();
+				m_map.clear();
+				if constexpr (std::is_base_of_v<std::random_access_iterator_tag, Category> && requires { m_map.reserve(0); })
+				{
+					m_map.reserve(2 * static_cast<std::size_t>(std::distance(first, last)));
+				}
+
+				SortedAppender appender(m_map, m_valBegin);
+				for (; first != last; ++first)
+				{
+					auto&& interval = *first;
+					appender.append(interval.keyBegin, interval.keyEnd, std::forward<decltype(interval)>(interval).val);
+				}
+				appender.finish();
+				journalContent();
+			}
+
+			// Replaces the whole content by intervals in any order.
+			// Overlaps are resolved as if the intervals were inserted one by one: the later one wins.
+			template <typename InputIt>
+			void assign(InputIt first, InputIt last)
+			{
+				const std::vector<Interval<K, V>> intervals(first, last);
+				const auto segments = detail::resolveLastWriterWins<K, V>(intervals);
+
+				m_version.bump();
+				m_map.clear();
+				SortedAppender appender(m_map, m_valBegin);
+				for (const auto& segment : segments)
+				{
+					appender.append(segment.keyBegin, segment.keyEnd, intervals[segment.source].val);
+				}
+				appender.finish();
+				journalContent();
+			}
+
+			// Same result as calling insert() for every interval in order.
+			// Shadowed intervals are dropped first, the rest is merged into the boundaries in one ordered sweep.
+			// With a journal attached the segments are inserted one by one, which records only what they change.
+			// Stats count every interval as an insert; a rebuild reports the net change of the boundary count.
+			void insertBatch(std::span<const Interval<K, V>> intervals)
+			{
+				m_stats.onBatchInserted(intervals.size());
+				const auto segments = detail::resolveLastWriterWins<K, V>(intervals);
+
+				if (m_journal || !isRebuildCheaper(segments.size()))
+				{
+					// Segments are disjoint, so applying them one by one cannot change the outcome
+					for (const auto& segment : segments)
+					{
+						insertAt(m_map.lower_bound(segment.keyBegin), m_map.upper_bound(segment.keyEnd), segment.keyBegin, segment.keyEnd, intervals[segment.source].val);
+					}
+					return;
+				}
+
+				MapType merged(m_map.get_allocator());
+				SortedAppender appender(merged, m_valBegin);
+
+				// Current content is [itOld->first, std::next(itOld)->first) -> itOld->second, valBegin elsewhere
+				auto itOld = m_map.begin();
+				auto appendOld = [&](const std::optional<K>& lo, const std::optional<K>& hi)
+				{
+					for (; itOld != m_map.end() && std::next(itOld) != m_map.end(); ++itOld)
+					{
+						const K& keyBegin = itOld->first;
+						const K& keyEnd = std::next(itOld)->first;
+						if (lo && !(*lo < keyEnd)) continue;
+						if (hi && !(keyBegin < *hi)) break;
+
+						appender.append((lo && keyBegin < *lo) ? *lo : keyBegin, (hi && *hi < keyEnd) ? *hi : keyEnd, itOld->second);
+
+						// This interval continues behind the segment
+						if (hi && *hi < keyEnd) break;
+					}
+				};
+
+				std::optional<K> lastEnd;
+				for (const auto& segment : segments)
+				{
+					appendOld(lastEnd, segment.keyBegin);
+					appender.append(segment.keyBegin, segment.keyEnd, intervals[segment.source].val);
+					lastEnd = segment.keyEnd;
+				}
+				appendOld(lastEnd, std::nullopt);
+				appender.finish();
+
+				if (merged.size() > m_map.size())
+				{
+					m_stats.onBoundariesCreated(merged.size() - m_map.size());
+				}
+				else
+				{
+					m_stats.onBoundariesErased(m_map.size() - merged.size());
+				}
+
+				m_version.bump();
+				m_map = std::move(merged);
 			}
 
 			void printAsIntervals() const
@@ -85,6 +516,7 @@ namespace DS
 
 			V const& operator[](K const& key) const
 			{
+				[[maybe_unused]] const auto sample = m_stats.onLookup();
 				auto it = m_map.upper_bound(key);
 				if (it == m_map.begin())
 				{
@@ -96,19 +528,377 @@ namespace DS
 				}
 			}
 
-			using MapType = std::map<K, V>;
+			// Resolves count keys in one call: out[i] = (*this)[keys[i]]
+			void lookupBatch(const K* keys, std::size_t count, V* out) const
+			{
+				if (!isBoundaryCopyCheaper(count))
+				{
+					lookupEach(keys, count, out);
+					return;
+				}
+				withBoundaryArrays([&](const K* bounds, std::size_t size, const auto& valueAt)
+				{
+					detail::upperBoundBatch(bounds, size, keys, count, [&](std::size_t i, std::size_t pos)
+					{
+						out[i] = (pos == 0) ? m_valBegin : valueAt(pos - 1);
+					});
+				});
+			}
+
+			// Same as lookupBatch, keys must be sorted in non-descending order
+			void lookupBatchSorted(const K* keys, std::size_t count, V* out) const
+			{
+				if (!isBoundaryCopyCheaper(count))
+				{
+					lookupEach(keys, count, out);
+					return;
+				}
+				withBoundaryArrays([&](const K* bounds, std::size_t size, const auto& valueAt)
+				{
+					detail::upperBoundSortedBatch(bounds, size, keys, count, [&](std::size_t i, std::size_t pos)
+					{
+						out[i] = (pos == 0) ? m_valBegin : valueAt(pos - 1);
+					});
+				});
+			}
+
+			// Walks the canonical intervals between the first and the last boundary, gaps with valBegin included.
+			// Views refer to the boundaries, so the iterator is invalidated like the ones of MapType.
+			class IntervalIterator
+			{
+				private:
+
+					using BoundaryIt = typename MapType::const_iterator;
+
+				public:
+
+					using iterator_concept = std::bidirectional_iterator_tag;
+					using iterator_category = std::input_iterator_tag; // Dereferencing yields a view, not a reference
+					using difference_type = std::ptrdiff_t;
+					using value_type = IntervalView<K, V>;
+					using reference = IntervalView<K, V>;
+
+				public:
+
+					IntervalIterator() = default;
+
+					explicit IntervalIterator(BoundaryIt it)
+					:
+						m_it(it)
+					{}
+
+				public:
+
+					reference operator*() const
+					{
+						const auto& [keyBegin, val] = *m_it;
+						return { keyBegin, std::next(m_it)->first, val };
+					}
+
+					IntervalIterator& operator++() { ++m_it; return *this; }
+					IntervalIterator& operator--() { --m_it; return *this; }
+					IntervalIterator operator++(int) { IntervalIterator tmp = *this; ++m_it; return tmp; }
+					IntervalIterator operator--(int) { IntervalIterator tmp = *this; --m_it; return tmp; }
+
+					friend bool operator==(const IntervalIterator& lhs, const IntervalIterator& rhs) { return lhs.m_it == rhs.m_it; }
+
+				private:
+
+					BoundaryIt m_it;
+			};
+
+			// Ordered, allocation free range of IntervalView
+			std::ranges::subrange<IntervalIterator> intervals() const
+			{
+				const auto itLast = m_map.empty() ? m_map.end() : std::prev(m_map.end());
+				return { IntervalIterator(m_map.begin()), IntervalIterator(itLast) };
+			}
+
+			// Calls visitor(IntervalView) for every maximal piece of [lo, hi) with one value, in key order.
+			// Pieces are clipped to [lo, hi) and include the valBegin regions. O(log n + k) for k visited pieces.
+			template <typename Visitor>
+			void query(const K& lo, const K& hi, Visitor&& visitor) const
+			{
+				if (!(lo < hi)) return;
+
+				auto it = m_map.upper_bound(lo);
+				const K* keyBegin = &lo;
+				const V* val = (it == m_map.begin()) ? &m_valBegin : &std::prev(it)->second;
+
+				for (; it != m_map.end() && it->first < hi; ++it)
+				{
+					const auto& [key, nextVal] = *it;
+					visitor(IntervalView<K, V>{ *keyBegin, key, *val });
+					keyBegin = &key;
+					val = &nextVal;
+				}
+				visitor(IntervalView<K, V>{ *keyBegin, hi, *val });
+			}
 
 			const MapType& getMap() const
 			{
 				return m_map;
 			}
 
+			// Value of every key below the first boundary (and of the empty map)
+			const V& valBegin() const
+			{
+				return m_valBegin;
+			}
+
+			// Changes whenever the boundaries may have changed: insert() when it adds, erases or reassigns a boundary,
+			// the assign and batch functions, and copy or move assignment. Writes made directly to m_map are not seen.
+			std::uint64_t version() const
+			{
+				return m_version.value();
+			}
+
+			// Records every later boundary mutation into journal, nullptr stops recording. The journal is not owned
+			// and stays with this object: copies of the map do not record, and assigning a whole map is not recorded
+			// either, replicas have to start over from a copy then.
+			void attachJournal(DeltaLog<K, V>* journal)
+			{
+				m_journal.reset(journal);
+			}
+
+			// Replays a journal recorded on a map which held the same boundaries as this one when it started.
+			// O(k log n) for k recorded operations, independent of the number of boundaries they leave alone.
+			void applyDelta(const DeltaLog<K, V>& delta)
+			{
+				using Kind = typename DeltaLog<K, V>::Kind;
+
+				m_version.bump();
+				const V* val = delta.values().data();
+				const K* last = delta.eraseLasts().data();
+				for (const auto& op : delta.ops())
+				{
+					switch (op.kind)
+					{
+						case Kind::Set:
+						{
+							if (m_journal) m_journal->recordSet(op.key, *val);
+							const auto it = m_map.lower_bound(op.key);
+							if (it != m_map.end() && !(op.key < it->first))
+							{
+								it->second = *val;
+							}
+							else
+							{
+								m_stats.onBoundariesCreated(1);
+								m_map.emplace_hint(it, op.key, *val);
+							}
+							++val;
+							break;
+						}
+						case Kind::Erase:
+						{
+							if (m_journal) m_journal->recordErase(op.key, *last);
+							const auto itBegin = m_map.lower_bound(op.key);
+							const auto itEnd = m_map.upper_bound(*last);
+							++last;
+							if constexpr (Stats::kEnabled)
+							{
+								m_stats.onBoundariesErased(static_cast<std::size_t>(std::distance(itBegin, itEnd)));
+							}
+							m_map.erase(itBegin, itEnd);
+							break;
+						}
+						case Kind::Clear:
+						{
+							if (m_journal) m_journal->recordClear();
+							m_stats.onBoundariesErased(m_map.size());
+							m_map.clear();
+							break;
+						}
+					}
+				}
+			}
+
+		private:
+
+			// Appends sorted, non-overlapping intervals behind the last boundary while keeping canonical form
+			class SortedAppender
+			{
+				public:
+
+					SortedAppender(MapType& map, const V& valBegin)
+					:
+						m_map(map),
+						m_valBegin(valBegin)
+					{}
+
+				public:
+
+					template <typename V_forward>
+					void append(const K& keyBegin, const K& keyEnd, V_forward&& val)
+					{
+						if (!(keyBegin < keyEnd)) return;
+						assert(!m_hasLastEnd || !(keyBegin < m_lastEnd));
+
+						// A gap after the previous interval falls back to the begin value
+						if (m_hasLastEnd && m_lastEnd < keyBegin && !(currentVal() == m_valBegin))
+						{
+							push(m_lastEnd, m_valBegin);
+						}
+						if (!(val == currentVal()))
+						{
+							push(keyBegin, std::forward<V_forward>(val));
+						}
+						m_lastEnd = keyEnd;
+						m_hasLastEnd = true;
+					}
+
+					void finish()
+					{
+						if (m_hasLastEnd && !(currentVal() == m_valBegin))
+						{
+							push(m_lastEnd, m_valBegin);
+						}
+					}
+
+				private:
+
+					const V& currentVal() const
+					{
+						return m_map.empty() ? m_valBegin : std::prev(m_map.end())->second;
+					}
+
+					template <typename V_forward>
+					void push(const K& key, V_forward&& val)
+					{
+						m_map.emplace_hint(m_map.end(), key, std::forward<V_forward>(val));
+					}
+
+				private:
+
+					MapType& m_map;
+					const V& m_valBegin;
+					// Not a std::optional, GCC 12 reports its payload as maybe-uninitialized under -Wall
+					bool m_hasLastEnd = false;
+					K m_lastEnd{};
+			};
+
+			// Records a replacement of the whole content
+			void journalContent()
+			{
+				if (!m_journal) return;
+
+				m_journal->recordClear();
+				for (const auto& [key, val] : m_map)
+				{
+					m_journal->recordSet(key, val);
+				}
+			}
+
+			// A rebuild costs O(n + m). Applying m segments one by one costs O(m log n) on a tree and O(m n) on flat arrays.
+			// Tree rebuilds also pay one allocation per boundary, hence the extra factor.
+			bool isRebuildCheaper(std::size_t segmentCount) const
+			{
+				using Category = typename std::iterator_traits<typename MapType::const_iterator>::iterator_category;
+
+				if constexpr (std::is_base_of_v<std::random_access_iterator_tag, Category>)
+				{
+					return segmentCount > 1;
+				}
+				else
+				{
+					return segmentCount * std::bit_width(m_map.size()) > 4 * m_map.size();
+				}
+			}
+
+			// A node based storage has to copy all n boundaries for a batch, m tree searches are cheaper when m log n < n.
+			// Contiguous storages are searched in place.
+			bool isBoundaryCopyCheaper(std::size_t count) const
+			{
+				if constexpr (requires { m_map.keys().data(); m_map.values().data(); })
+				{
+					return true;
+				}
+				else
+				{
+					return count * std::bit_width(m_map.size()) >= m_map.size();
+				}
+			}
+
+			void lookupEach(const K* keys, std::size_t count, V* out) const
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					const auto it = m_map.upper_bound(keys[i]);
+					out[i] = (it == m_map.begin()) ? m_valBegin : std::prev(it)->second;
+				}
+			}
+
+			// Calls func(keys, size, valueAt) over contiguous boundary keys.
+			// Node based storages get a temporary copy, its cost is amortized over the batch.
+			template <typename Func>
+			void withBoundaryArrays(Func&& func) const
+			{
+				if constexpr (requires { m_map.keys().data(); m_map.values().data(); })
+				{
+					const V* values = m_map.values().data();
+					func(m_map.keys().data(), m_map.size(), [values](std::size_t i) -> const V& { return values[i]; });
+				}
+				else
+				{
+					std::vector<K> keys;
+					std::vector<const V*> values;
+					keys.reserve(m_map.size());
+					values.reserve(m_map.size());
+					for (const auto& [key, val] : m_map)
+					{
+						keys.push_back(key);
+						values.push_back(&val);
+					}
+					func(keys.data(), keys.size(), [&values](std::size_t i) -> const V& { return *values[i]; });
+				}
+			}
+
+		public:
+
+			const Stats& stats() const
+			{
+				return m_stats;
+			}
+
+			// Counters of the stats policy together with the gauges of the map
+			StatsSnapshot statsSnapshot() const
+				requires Stats::kEnabled
+			{
+				StatsSnapshot snapshot = m_stats.snapshot();
+				snapshot.boundaries = m_map.size();
+				if constexpr (requires { m_map.keys().data(); m_map.values().data(); })
+				{
+					snapshot.bytes = m_map.size() * (sizeof(K) + sizeof(V));
+				}
+				else
+				{
+					// Tree node: three links and the color next to the element
+					snapshot.bytes = m_map.size() * (sizeof(typename MapType::value_type) + 4 * sizeof(void*));
+				}
+				return snapshot;
+			}
+
 		private:
 
 			V m_valBegin;
+			DS_NO_UNIQUE_ADDRESS Stats m_stats;
+			detail::Version m_version;
+			detail::LocalPtr<DeltaLog<K, V>> m_journal;
 
 		public:
 
-			std::map<K, V> m_map;
+			MapType m_map;
 	};
+
+	// Maps of a few dozen boundaries, e.g. per-request feature flags over version ranges
+	template <typename K, typename V, std::size_t N>
+	using SmallIntervalMap = IntervalMap<K, V, SmallStorage<N>>;
+
+	namespace pmr
+	{
+		// Boundaries come from a std::pmr::memory_resource, e.g. a monotonic arena dropped at once with the map
+		template <typename K, typename V, typename Storage = TreeStorage>
+		using IntervalMap = DS::IntervalMap<K, V, Storage, std::pmr::polymorphic_allocator<std::pair<const K, V>>>;
+	}
 }
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <queue>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "Interval.hpp"
+
+namespace DS::detail
+{
+	// Piece of the resolved key space, owned by intervals[source]
+	template <typename K>
+	struct Segment
+	{
+		K keyBegin;
+		K keyEnd;
+		std::size_t source;
+	};
+
+	// Below this amount of intervals the work is not worth a thread
+	inline constexpr std::size_t kMinIntervalsPerThread = 1 << 14;
+
+	// Sweeps over the interval endpoints clipped to [lo, hi), a missing bound means unbounded.
+	// A max-heap of interval indices gives the latest interval covering each elementary segment.
+	template <typename K, typename V>
+	std::vector<Segment<K>> resolveRange(std::span<const Interval<K, V>> intervals, const std::optional<K>& lo, const std::optional<K>& hi)
+	{
+		struct Event
+		{
+			K key;
+			std::size_t source;
+			bool isBegin;
+		};
+
+		std::vector<Event> events;
+		for (std::size_t i = 0; i < intervals.size(); ++i)
+		{
+			const K& keyBegin = (lo && intervals[i].keyBegin < *lo) ? *lo : intervals[i].keyBegin;
+			const K& keyEnd = (hi && *hi < intervals[i].keyEnd) ? *hi : intervals[i].keyEnd;
+			if (keyBegin < keyEnd)
+			{
+				events.push_back({ keyBegin, i, true });
+				events.push_back({ keyEnd, i, false });
+			}
+		}
+		std::sort(events.begin(), events.end(), [](const Event& lhs, const Event& rhs) { return lhs.key < rhs.key; });
+
+		std::vector<Segment<K>> segments;
+		std::priority_queue<std::size_t> active;
+		std::vector<bool> isEnded(intervals.size(), false);
+
+		for (auto it = events.begin(); it != events.end();)
+		{
+			const K& key = it->key;
+			for (; it != events.end() && !(key < it->key); ++it)
+			{
+				if (it->isBegin)
+				{
+					active.push(it->source);
+				}
+				else
+				{
+					isEnded[it->source] = true;
+				}
+			}
+
+			// Lazy deletion: ended intervals are dropped only when they surface
+			while (!active.empty() && isEnded[active.top()])
+			{
+				active.pop();
+			}
+			if (active.empty() || it == events.end())
+			{
+				continue;
+			}
+
+			if (!segments.empty() && segments.back().source == active.top() && !(segments.back().keyEnd < key))
+			{
+				segments.back().keyEnd = it->key;
+			}
+			else
+			{
+				segments.push_back({ key, it->key, active.top() });
+			}
+		}
+		return segments;
+	}
+
+	// Resolves overlapping intervals as if they were inserted one by one in order: later intervals win.
+	// Returns sorted, disjoint, non-empty segments. The key space is split into threadCount ranges resolved in parallel.
+	template <typename K, typename V>
+	std::vector<Segment<K>> resolveLastWriterWins(std::span<const Interval<K, V>> intervals, std::size_t threadCount)
+	{
+		if (threadCount < 2 || intervals.empty())
+		{
+			return resolveRange<K, V>(intervals, std::nullopt, std::nullopt);
+		}
+
+		// Split keys are quantiles of a strided sample of interval begins
+		std::vector<K> sample;
+		const std::size_t stride = std::max<std::size_t>(1, intervals.size() / (threadCount * 64));
+		for (std::size_t i = 0; i < intervals.size(); i += stride)
+		{
+			sample.push_back(intervals[i].keyBegin);
+		}
+		std::sort(sample.begin(), sample.end());
+
+		std::vector<std::optional<K>> splits{ std::nullopt };
+		for (std::size_t i = 1; i < threadCount; ++i)
+		{
+			const K& split = sample[i * sample.size() / threadCount];
+			if (!splits.back() || *splits.back() < split)
+			{
+				splits.push_back(split);
+			}
+		}
+		splits.push_back(std::nullopt);
+
+		std::vector<std::vector<Segment<K>>> parts(splits.size() - 1);
+		{
+			std::vector<std::thread> workers;
+			for (std::size_t i = 0; i + 1 < splits.size(); ++i)
+			{
+				workers.emplace_back([&, i] { parts[i] = resolveRange<K, V>(intervals, splits[i], splits[i + 1]); });
+			}
+			for (auto& worker : workers)
+			{
+				worker.join();
+			}
+		}
+
+		// Stitch the ranges, gluing pieces of one interval cut by a split key
+		std::vector<Segment<K>> segments = std::move(parts.front());
+		for (std::size_t i = 1; i < parts.size(); ++i)
+		{
+			auto it = parts[i].begin();
+			if (it != parts[i].end() && !segments.empty() &&
+				segments.back().source == it->source && !(segments.back().keyEnd < it->keyBegin))
+			{
+				segments.back().keyEnd = it->keyEnd;
+				++it;
+			}
+			segments.insert(segments.end(), it, parts[i].end());
+		}
+		return segments;
+	}
+
+	template <typename K, typename V>
+	std::vector<Segment<K>> resolveLastWriterWins(std::span<const Interval<K, V>> intervals)
+	{
+		const std::size_t threadCount = std::min<std::size_t>(
+			std::max(1u, std::thread::hardware_concurrency()),
+			intervals.size() / kMinIntervalsPerThread);
+
+		return resolveLastWriterWins<K, V>(intervals, threadCount);
+	}
+}
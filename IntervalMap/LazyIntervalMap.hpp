@@ -0,0 +1,455 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Interval.hpp"
+#include "IntervalMap.hpp"
+
+namespace DS
+{
+	// Interval map with deferred range updates. Boundaries live in a treap (a randomized balanced search tree)
+	// whose nodes carry lazy tags. A tag is a chain of transforms composed in O(1), so transforms are never called
+	// while tags move down the tree; a value only runs through its chain when it is read.
+	// - transform() and insert() split the tree at both ends of their range: O(log n) expected, no transform called.
+	// - operator[] walks one path, O(log n), then calls each transform which covers the key and was not applied
+	//   to the boundary before it yet. The result is kept, a second lookup there calls nothing.
+	// - materialize() applies every remaining transform once per boundary it covers and drops the boundaries
+	//   which became redundant: O(n) plus those calls. Iteration goes through it.
+	// Const members may apply tags, so even readers must not share the object between threads.
+	template <typename K, typename V, typename Storage = TreeStorage>
+	class LazyIntervalMap
+	{
+		public:
+
+			using Transform = std::function<V(const V&)>;
+			using MapType = typename IntervalMap<K, V, Storage>::MapType;
+
+		private:
+
+			struct Link;
+			using Chain = std::shared_ptr<const Link>;
+
+			// Transform f, or first then second. Links are shared by the chains composed from them.
+			struct Link
+			{
+				explicit Link(Transform transform)
+				:
+					f(std::move(transform))
+				{}
+
+				Link(Chain lhs, Chain rhs)
+				:
+					first(std::move(lhs)),
+					second(std::move(rhs))
+				{}
+
+				// Long chains would otherwise be freed recursively, one frame per link
+				~Link()
+				{
+					if (!first && !second) return;
+
+					std::vector<Chain> orphans;
+					orphans.push_back(std::move(first));
+					orphans.push_back(std::move(second));
+					while (!orphans.empty())
+					{
+						Chain link = std::move(orphans.back());
+						orphans.pop_back();
+						if (link && link.use_count() == 1)
+						{
+							orphans.push_back(std::move(link->first));
+							orphans.push_back(std::move(link->second));
+						}
+					}
+				}
+
+				Transform f;
+				mutable Chain first;
+				mutable Chain second;
+			};
+
+			struct Node
+			{
+				K key;
+				V val;
+				std::uint32_t priority;
+				std::unique_ptr<Node> left;
+				std::unique_ptr<Node> right;
+
+				Chain pending; // Still to be applied to val
+				Chain tag;     // Still to be applied to val and to both subtrees
+			};
+
+		public:
+
+			LazyIntervalMap()
+			:
+				LazyIntervalMap(V{})
+			{}
+
+			template<typename V_forward>
+				requires (!std::is_same_v<std::remove_cvref_t<V_forward>, LazyIntervalMap>)
+			LazyIntervalMap(V_forward&& val)
+			:
+				m_valBegin(std::forward<V_forward>(val))
+			{}
+
+			LazyIntervalMap(const LazyIntervalMap& other)
+			:
+				m_valBegin(other.m_valBegin),
+				m_root(clone(other.m_root.get())),
+				m_pendingCount(other.m_pendingCount),
+				m_seed(other.m_seed)
+			{}
+
+			LazyIntervalMap& operator=(const LazyIntervalMap& other)
+			{
+				if (this != &other)
+				{
+					*this = LazyIntervalMap(other);
+				}
+				return *this;
+			}
+
+			LazyIntervalMap(LazyIntervalMap&&) = default;
+			LazyIntervalMap& operator=(LazyIntervalMap&&) = default;
+
+		public:
+
+			// Boundaries are not compared, redundant ones are dropped by materialize()
+			template<typename V_forward>
+			void insert(const K& keyBegin, const K& keyEnd, V_forward&& val)
+			{
+				if (!(keyBegin < keyEnd)) return;
+
+				m_materialized.reset();
+
+				// Boundaries below keyBegin, inside [keyBegin, keyEnd], above keyEnd
+				auto [below, rest] = split<false>(std::move(m_root), keyBegin);
+				auto [inside, above] = split<true>(std::move(rest), keyEnd);
+
+				// The value at keyEnd is the one of the last boundary up to it
+				const Node* last = lastNode(inside.get());
+				auto end = copyNode(keyEnd, last ? last : lastNode(below.get()));
+				inside.reset();
+
+				auto middle = merge(makeNode(keyBegin, std::forward<V_forward>(val), nullptr), std::move(end));
+				m_root = merge(merge(std::move(below), std::move(middle)), std::move(above));
+			}
+
+			// Every value in [keyBegin, keyEnd) becomes f(value), e.g. an increment of a counter range
+			template<typename F>
+			void transform(const K& keyBegin, const K& keyEnd, F&& f)
+			{
+				if (!(keyBegin < keyEnd)) return;
+
+				m_materialized.reset();
+				++m_pendingCount;
+
+				// Boundaries below keyBegin, inside [keyBegin, keyEnd), from keyEnd on
+				auto [below, rest] = split<false>(std::move(m_root), keyBegin);
+				auto [inside, above] = split<false>(std::move(rest), keyEnd);
+
+				// Boundaries at both ends, so the tag covers exactly [keyBegin, keyEnd)
+				const Node* before = lastNode(below.get());
+				if (!startsAt(above.get(), keyEnd))
+				{
+					const Node* last = lastNode(inside.get());
+					above = merge(copyNode(keyEnd, last ? last : before), std::move(above));
+				}
+				if (!startsAt(inside.get(), keyBegin))
+				{
+					inside = merge(copyNode(keyBegin, before), std::move(inside));
+				}
+
+				inside->tag = then(std::move(inside->tag), std::make_shared<const Link>(Transform(std::forward<F>(f))));
+				m_root = merge(merge(std::move(below), std::move(inside)), std::move(above));
+			}
+
+			// Every value of the map becomes f(value), valBegin included, e.g. a rewrite of X to Y everywhere
+			template<typename F>
+			void transformAll(F&& f)
+			{
+				m_materialized.reset();
+				++m_pendingCount;
+
+				auto link = std::make_shared<const Link>(Transform(std::forward<F>(f)));
+				m_valBegin = link->f(m_valBegin);
+				if (m_root)
+				{
+					m_root->tag = then(std::move(m_root->tag), std::move(link));
+				}
+			}
+
+			// By value: the result may not be stored anywhere yet
+			V operator[](const K& key) const
+			{
+				Node* floor = nullptr;
+				for (Node* node = m_root.get(); node != nullptr;)
+				{
+					push(node);
+					if (key < node->key)
+					{
+						node = node->left.get();
+					}
+					else
+					{
+						floor = node;
+						node = node->right.get();
+					}
+				}
+				return floor ? resolve(floor) : m_valBegin;
+			}
+
+			// Applies the pending transforms and drops the boundaries they made redundant, the returned map is canonical.
+			// Returned by value: the next write drops the cached map this copy is made from.
+			IntervalMap<K, V, Storage> materialize() const
+			{
+				return materialized();
+			}
+
+			// Valid until the next insert(), transform() or transformAll()
+			const MapType& getMap() const
+			{
+				return materialized().getMap();
+			}
+
+			const V& valBegin() const
+			{
+				return m_valBegin;
+			}
+
+			// Valid until the next insert(), transform() or transformAll()
+			auto intervals() const
+			{
+				return materialized().intervals();
+			}
+
+			// Transforms made since the last materialize()
+			std::size_t pendingCount() const
+			{
+				return m_pendingCount;
+			}
+
+		private:
+
+			const IntervalMap<K, V, Storage>& materialized() const
+			{
+				if (m_materialized) return *m_materialized;
+
+				std::vector<std::unique_ptr<Node>> nodes;
+				collect(std::move(m_root), nodes);
+
+				// Every boundary but the last starts an interval, the last one goes back to valBegin
+				std::vector<Interval<K, V>> intervals;
+				intervals.reserve(nodes.size());
+				for (std::size_t i = 0; i + 1 < nodes.size(); ++i)
+				{
+					intervals.push_back({ nodes[i]->key, nodes[i + 1]->key, nodes[i]->val });
+				}
+
+				m_materialized.emplace(m_valBegin);
+				m_materialized->assignSorted(intervals.begin(), intervals.end());
+				m_root = build(nodes, m_materialized->getMap());
+				m_pendingCount = 0;
+				return *m_materialized;
+			}
+
+			// first, then second
+			static Chain then(Chain first, Chain second)
+			{
+				if (!first) return second;
+				if (!second) return first;
+				return std::make_shared<const Link>(std::move(first), std::move(second));
+			}
+
+			// Hands the tag of node down to its value and its children, no transform is called
+			static void push(Node* node)
+			{
+				if (!node->tag) return;
+
+				node->pending = then(std::move(node->pending), node->tag);
+				for (Node* child : { node->left.get(), node->right.get() })
+				{
+					if (child)
+					{
+						child->tag = then(std::move(child->tag), node->tag);
+					}
+				}
+				node->tag.reset();
+			}
+
+			// Runs the value of a pushed node through its pending chain, in order and without recursion
+			static const V& resolve(Node* node)
+			{
+				if (!node->pending) return node->val;
+
+				std::vector<const Link*> stack = { node->pending.get() };
+				while (!stack.empty())
+				{
+					const Link* link = stack.back();
+					stack.pop_back();
+					if (link->f)
+					{
+						node->val = link->f(node->val);
+					}
+					else
+					{
+						stack.push_back(link->second.get());
+						stack.push_back(link->first.get());
+					}
+				}
+				node->pending.reset();
+				return node->val;
+			}
+
+			// Last boundary, pushed
+			static const Node* lastNode(Node* node)
+			{
+				if (!node) return nullptr;
+
+				for (push(node); node->right; push(node))
+				{
+					node = node->right.get();
+				}
+				return node;
+			}
+
+			// Whether the first boundary is at key. Tags never change keys, nothing is pushed.
+			static bool startsAt(const Node* node, const K& key)
+			{
+				if (!node) return false;
+
+				while (node->left)
+				{
+					node = node->left.get();
+				}
+				return !(node->key < key) && !(key < node->key);
+			}
+
+			// Inclusive: (keys <= key, keys > key), otherwise (keys < key, keys >= key)
+			template <bool Inclusive>
+			static std::pair<std::unique_ptr<Node>, std::unique_ptr<Node>> split(std::unique_ptr<Node> node, const K& key)
+			{
+				if (!node) return {};
+
+				push(node.get());
+				const bool goesLeft = Inclusive ? !(key < node->key) : node->key < key;
+				if (goesLeft)
+				{
+					auto [lhs, rhs] = split<Inclusive>(std::move(node->right), key);
+					node->right = std::move(lhs);
+					return { std::move(node), std::move(rhs) };
+				}
+				else
+				{
+					auto [lhs, rhs] = split<Inclusive>(std::move(node->left), key);
+					node->left = std::move(rhs);
+					return { std::move(lhs), std::move(node) };
+				}
+			}
+
+			// Every key of lhs is less than every key of rhs. The tag of a node which gets a new child cannot
+			// apply to that child, so it is pushed first.
+			static std::unique_ptr<Node> merge(std::unique_ptr<Node> lhs, std::unique_ptr<Node> rhs)
+			{
+				if (!lhs) return rhs;
+				if (!rhs) return lhs;
+
+				if (lhs->priority > rhs->priority)
+				{
+					push(lhs.get());
+					lhs->right = merge(std::move(lhs->right), std::move(rhs));
+					return lhs;
+				}
+				push(rhs.get());
+				rhs->left = merge(std::move(lhs), std::move(rhs->left));
+				return rhs;
+			}
+
+			// Takes the nodes apart in key order, every value resolved
+			static void collect(std::unique_ptr<Node> node, std::vector<std::unique_ptr<Node>>& out)
+			{
+				if (!node) return;
+
+				push(node.get());
+				resolve(node.get());
+				collect(std::move(node->left), out);
+				auto right = std::move(node->right);
+				out.push_back(std::move(node));
+				collect(std::move(right), out);
+			}
+
+			// Treap of the nodes whose keys are boundaries of map, both in key order. Linear: the stack holds the
+			// right spine, right links are set once a node leaves it.
+			static std::unique_ptr<Node> build(std::vector<std::unique_ptr<Node>>& nodes, const MapType& map)
+			{
+				std::vector<std::unique_ptr<Node>> spine;
+				auto itMap = map.begin();
+				for (auto& node : nodes)
+				{
+					if (itMap == map.end() || itMap->first < node->key || node->key < itMap->first) continue;
+					++itMap;
+
+					std::unique_ptr<Node> last;
+					while (!spine.empty() && spine.back()->priority < node->priority)
+					{
+						spine.back()->right = std::move(last);
+						last = std::move(spine.back());
+						spine.pop_back();
+					}
+					node->left = std::move(last);
+					spine.push_back(std::move(node));
+				}
+
+				std::unique_ptr<Node> root;
+				while (!spine.empty())
+				{
+					spine.back()->right = std::move(root);
+					root = std::move(spine.back());
+					spine.pop_back();
+				}
+				return root;
+			}
+
+			template <typename V_forward>
+			std::unique_ptr<Node> makeNode(const K& key, V_forward&& val, Chain pending)
+			{
+				// xorshift32, balance only needs the priorities to look independent
+				m_seed ^= m_seed << 13;
+				m_seed ^= m_seed >> 17;
+				m_seed ^= m_seed << 5;
+
+				return std::make_unique<Node>(Node{ key, std::forward<V_forward>(val), m_seed, nullptr, nullptr, std::move(pending), nullptr });
+			}
+
+			// New boundary at key holding the value of source, a pushed node, or valBegin without one.
+			// The pending chain is shared, not run.
+			std::unique_ptr<Node> copyNode(const K& key, const Node* source)
+			{
+				return source ? makeNode(key, source->val, source->pending) : makeNode(key, m_valBegin, nullptr);
+			}
+
+			static std::unique_ptr<Node> clone(const Node* node)
+			{
+				if (!node) return nullptr;
+
+				return std::make_unique<Node>(Node{ node->key, node->val, node->priority, clone(node->left.get()), clone(node->right.get()), node->pending, node->tag });
+			}
+
+		private:
+
+			V m_valBegin;
+			mutable std::unique_ptr<Node> m_root;
+			mutable std::optional<IntervalMap<K, V, Storage>> m_materialized;
+			mutable std::size_t m_pendingCount = 0;
+			std::uint32_t m_seed = 2463534242u;
+	};
+}
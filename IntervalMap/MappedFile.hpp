@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DS::detail
+{
+	// Read-only memory mapping of a whole file. Pages are loaded lazily by the OS.
+	class MappedFile
+	{
+		public:
+
+			explicit MappedFile(const std::string& path)
+			{
+#if defined(_WIN32)
+				m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (m_file == INVALID_HANDLE_VALUE) fail("cannot open", path);
+
+				LARGE_INTEGER size;
+				if (!GetFileSizeEx(m_file, &size)) fail("cannot stat", path);
+				m_size = static_cast<std::size_t>(size.QuadPart);
+
+				if (m_size != 0)
+				{
+					m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+					if (m_mapping == nullptr) fail("cannot map", path);
+
+					m_data = static_cast<const std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+					if (m_data == nullptr) fail("cannot map", path);
+				}
+#else
+				m_fd = ::open(path.c_str(), O_RDONLY);
+				if (m_fd < 0) fail("cannot open", path);
+
+				struct stat info;
+				if (::fstat(m_fd, &info) != 0) fail("cannot stat", path);
+				m_size = static_cast<std::size_t>(info.st_size);
+
+				if (m_size != 0)
+				{
+					void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_fd, 0);
+					if (data == MAP_FAILED) fail("cannot map", path);
+					m_data = static_cast<const std::byte*>(data);
+				}
+#endif
+			}
+
+			MappedFile(MappedFile&& other) noexcept
+			{
+				swap(other);
+			}
+
+			MappedFile& operator=(MappedFile&& other) noexcept
+			{
+				MappedFile(std::move(other)).swap(*this);
+				return *this;
+			}
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			~MappedFile()
+			{
+				close();
+			}
+
+		public:
+
+			const std::byte* data() const { return m_data; }
+			std::size_t size() const { return m_size; }
+
+		private:
+
+			void swap(MappedFile& other) noexcept
+			{
+				std::swap(m_data, other.m_data);
+				std::swap(m_size, other.m_size);
+#if defined(_WIN32)
+				std::swap(m_file, other.m_file);
+				std::swap(m_mapping, other.m_mapping);
+#else
+				std::swap(m_fd, other.m_fd);
+#endif
+			}
+
+			void close()
+			{
+#if defined(_WIN32)
+				if (m_data != nullptr) UnmapViewOfFile(m_data);
+				if (m_mapping != nullptr) CloseHandle(m_mapping);
+				if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+				m_mapping = nullptr;
+				m_file = INVALID_HANDLE_VALUE;
+#else
+				if (m_data != nullptr) ::munmap(const_cast<std::byte*>(m_data), m_size);
+				if (m_fd >= 0) ::close(m_fd);
+				m_fd = -1;
+#endif
+				m_data = nullptr;
+				m_size = 0;
+			}
+
+			[[noreturn]] void fail(const char* what, const std::string& path)
+			{
+				close();
+				throw std::runtime_error(std::string("MappedFile: ") + what + " '" + path + "'");
+			}
+
+		private:
+
+			const std::byte* m_data = nullptr;
+			std::size_t m_size = 0;
+#if defined(_WIN32)
+			HANDLE m_file = INVALID_HANDLE_VALUE;
+			HANDLE m_mapping = nullptr;
+#else
+			int m_fd = -1;
+#endif
+	};
+}
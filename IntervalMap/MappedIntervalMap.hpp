@@ -0,0 +1,87 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "BatchSearch.hpp"
+#include "BinaryFormat.hpp"
+#include "IntervalMap.hpp"
+#include "MappedFile.hpp"
+
+namespace DS
+{
+	// Read-only view of a file written by writeBinary()/saveBinary(). Lookups search the mapped pages directly,
+	// opening only validates the header, so start-up cost does not depend on the map size.
+	template <typename K, typename V>
+	class MappedIntervalMap
+	{
+		static_assert(binary::kIsPortable<K> && binary::kIsPortable<V>, "Binary format needs trivially copyable K and V with a defined byte order");
+		static_assert(std::endian::native == std::endian::little, "Zero-copy view needs a little-endian host");
+
+		public:
+
+			// Throws std::runtime_error if the file cannot be mapped or was written for other K/V
+			explicit MappedIntervalMap(const std::string& path)
+			:
+				m_file(path)
+			{
+				const binary::Header header = binary::readHeader<K, V>(m_file.data(), m_file.size());
+				m_valBegin = reinterpret_cast<const V*>(m_file.data() + header.valBeginOffset);
+				m_keys = reinterpret_cast<const K*>(m_file.data() + header.keysOffset);
+				m_values = reinterpret_cast<const V*>(m_file.data() + header.valuesOffset);
+				m_size = static_cast<std::size_t>(header.count);
+			}
+
+		public:
+
+			V const& operator[](K const& key) const
+			{
+				const std::size_t pos = detail::branchlessUpperBound(m_keys, m_size, key);
+				return (pos == 0) ? *m_valBegin : m_values[pos - 1];
+			}
+
+			// Resolves count keys in one call: out[i] = (*this)[keys[i]]
+			void lookupBatch(const K* keys, std::size_t count, V* out) const
+			{
+				detail::upperBoundBatch(m_keys, m_size, keys, count, [&](std::size_t i, std::size_t pos)
+				{
+					out[i] = (pos == 0) ? *m_valBegin : m_values[pos - 1];
+				});
+			}
+
+			// Number of boundaries
+			std::size_t size() const { return m_size; }
+			bool empty() const { return m_size == 0; }
+
+			const V& valBegin() const { return *m_valBegin; }
+			std::span<const K> keys() const { return { m_keys, m_size }; }
+			std::span<const V> values() const { return { m_values, m_size }; }
+
+			// Copies the content into a regular, modifiable map
+			template <typename Storage = TreeStorage>
+			IntervalMap<K, V, Storage> toIntervalMap() const
+			{
+				std::vector<Interval<K, V>> intervals;
+				intervals.reserve(m_size);
+				for (std::size_t i = 0; i + 1 < m_size; ++i)
+				{
+					intervals.push_back({ m_keys[i], m_keys[i + 1], m_values[i] });
+				}
+
+				IntervalMap<K, V, Storage> iMap(*m_valBegin);
+				iMap.assignSorted(intervals.begin(), intervals.end());
+				return iMap;
+			}
+
+		private:
+
+			detail::MappedFile m_file;
+			const V* m_valBegin = nullptr;
+			const K* m_keys = nullptr;
+			const V* m_values = nullptr;
+			std::size_t m_size = 0;
+	};
+}
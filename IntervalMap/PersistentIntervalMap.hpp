@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace DS
+{
+	// Persistent (copy-on-write) interval map. Boundaries live in an immutable treap shared between versions:
+	// snapshot() is O(1) and insert() copies only the O(log n) nodes on the paths it touches.
+	// Lookup semantics are the same as IntervalMap, including m_valBegin below the first boundary.
+	template <typename K, typename V, typename Allocator = std::allocator<std::pair<const K, V>>>
+	class PersistentIntervalMap
+	{
+		private:
+
+			struct Node;
+			using NodePtr = std::shared_ptr<const Node>;
+
+			struct Node
+			{
+				K key;
+				V val;
+				std::uint64_t priority;
+				std::size_t size;
+				NodePtr left;
+				NodePtr right;
+			};
+
+			using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+
+		public:
+
+			PersistentIntervalMap()
+			:
+				PersistentIntervalMap(V{})
+			{}
+
+			template<typename V_forward>
+				requires (!std::is_same_v<std::remove_cvref_t<V_forward>, PersistentIntervalMap>)
+			PersistentIntervalMap(V_forward&& val, const Allocator& alloc = Allocator())
+			:
+				m_valBegin(std::forward<V_forward>(val)),
+				m_alloc(alloc)
+			{}
+
+		public:
+
+			// Independent version sharing every node with this one
+			PersistentIntervalMap snapshot() const
+			{
+				return *this;
+			}
+
+			template<typename V_forward>
+			void insert(const K& keyBegin, const K& keyEnd, V_forward&& val)
+			{
+				if (!(keyBegin < keyEnd)) return;
+
+				const V& prevBeginVal = valueBefore(keyBegin);
+				const V& prevEndVal = (*this)[keyEnd];
+
+				const bool isSameValAsPrevBegin = (val == prevBeginVal);
+				const bool isSameValAsPrevEnd = (val == prevEndVal);
+
+				// The right edge has to be built before val may be moved away
+				NodePtr middle;
+				if (!isSameValAsPrevEnd)
+				{
+					middle = makeNode(keyEnd, prevEndVal, nullptr, nullptr);
+				}
+				if (!isSameValAsPrevBegin)
+				{
+					middle = merge(makeNode(keyBegin, std::forward<V_forward>(val), nullptr, nullptr), middle);
+				}
+
+				// Everything in [keyBegin, keyEnd] is replaced by the middle part
+				auto [left, rest] = split(m_root, keyBegin, false);
+				auto [erased, right] = split(rest, keyEnd, true);
+				m_root = merge(merge(left, middle), right);
+			}
+
+			V const& operator[](K const& key) const
+			{
+				const V* result = &m_valBegin;
+				for (const Node* node = m_root.get(); node != nullptr;)
+				{
+					if (key < node->key)
+					{
+						node = node->left.get();
+					}
+					else
+					{
+						result = &node->val;
+						node = node->right.get();
+					}
+				}
+				return *result;
+			}
+
+			std::size_t size() const
+			{
+				return sizeOf(m_root);
+			}
+
+			bool empty() const
+			{
+				return m_root == nullptr;
+			}
+
+			// Visits boundaries in key order as func(key, val)
+			template <typename Func>
+			void forEachBoundary(Func&& func) const
+			{
+				visit(m_root.get(), func);
+			}
+
+		private:
+
+			// Value in effect right before key: the one of the greatest boundary strictly less than key
+			const V& valueBefore(const K& key) const
+			{
+				const V* result = &m_valBegin;
+				for (const Node* node = m_root.get(); node != nullptr;)
+				{
+					if (node->key < key)
+					{
+						result = &node->val;
+						node = node->right.get();
+					}
+					else
+					{
+						node = node->left.get();
+					}
+				}
+				return *result;
+			}
+
+			// Priorities derive from keys, so the shape of a version does not depend on its history
+			static std::uint64_t priorityOf(const K& key)
+			{
+				std::uint64_t x = static_cast<std::uint64_t>(std::hash<K>{}(key)) + 0x9E3779B97F4A7C15ull;
+				x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+				x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+				return x ^ (x >> 31);
+			}
+
+			static std::size_t sizeOf(const NodePtr& node)
+			{
+				return node ? node->size : 0;
+			}
+
+			template <typename V_forward>
+			NodePtr makeNode(const K& key, V_forward&& val, NodePtr left, NodePtr right) const
+			{
+				const std::size_t size = 1 + sizeOf(left) + sizeOf(right);
+				return std::allocate_shared<Node>(NodeAllocator(m_alloc),
+					Node{ key, std::forward<V_forward>(val), priorityOf(key), size, std::move(left), std::move(right) });
+			}
+
+			// Path copy of node with new children
+			NodePtr withChildren(const NodePtr& node, NodePtr left, NodePtr right) const
+			{
+				if (node->left == left && node->right == right) return node;
+
+				const std::size_t size = 1 + sizeOf(left) + sizeOf(right);
+				return std::allocate_shared<Node>(NodeAllocator(m_alloc),
+					Node{ node->key, node->val, node->priority, size, std::move(left), std::move(right) });
+			}
+
+			// Splits into keys below key (or not above it when inclusive) and the rest
+			std::pair<NodePtr, NodePtr> split(const NodePtr& node, const K& key, bool inclusive) const
+			{
+				if (!node) return {};
+
+				const bool goesLeft = inclusive ? !(key < node->key) : node->key < key;
+				if (goesLeft)
+				{
+					auto [left, right] = split(node->right, key, inclusive);
+					return { withChildren(node, node->left, std::move(left)), std::move(right) };
+				}
+				else
+				{
+					auto [left, right] = split(node->left, key, inclusive);
+					return { std::move(left), withChildren(node, std::move(right), node->right) };
+				}
+			}
+
+			// Every key of left is less than every key of right
+			NodePtr merge(const NodePtr& left, const NodePtr& right) const
+			{
+				if (!left) return right;
+				if (!right) return left;
+
+				if (left->priority > right->priority)
+				{
+					return withChildren(left, left->left, merge(left->right, right));
+				}
+				return withChildren(right, merge(left, right->left), right->right);
+			}
+
+			template <typename Func>
+			static void visit(const Node* node, Func& func)
+			{
+				if (node == nullptr) return;
+
+				visit(node->left.get(), func);
+				func(node->key, node->val);
+				visit(node->right.get(), func);
+			}
+
+		private:
+
+			V m_valBegin;
+			NodePtr m_root;
+			Allocator m_alloc;
+	};
+}
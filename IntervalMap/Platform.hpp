@@ -0,0 +1,8 @@
+#pragma once
+
+// MSVC accepts the standard attribute but ignores it, empty members then still take a padded byte
+#if defined(_MSC_VER)
+#define DS_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define DS_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include "Interval.hpp"
+#include "IntervalMap.hpp"
+
+namespace DS
+{
+	// Interval map for many writer threads. The key domain is split into range shards at fixed split keys,
+	// shard i covering [splitKeys[i - 1], splitKeys[i]), each one an IntervalMap behind its own lock.
+	// Writers of different shards never wait for each other. An insertion crossing shards is clipped into each of them
+	// and applied under all their locks, taken in ascending shard order, so nobody observes half of it.
+	// Every shard holds exactly the restriction of the whole map to its range: lookups need no stitching,
+	// the boundaries shards add at their edges are removed by snapshot().
+	template <typename K, typename V, typename Storage = TreeStorage>
+	class ShardedIntervalMap
+	{
+		private:
+
+			struct alignas(64) Shard
+			{
+				mutable std::shared_mutex mutex;
+				IntervalMap<K, V, Storage> map;
+			};
+
+		public:
+
+			// splitKeys have to be strictly increasing, n split keys give n + 1 shards
+			template <typename V_forward>
+			ShardedIntervalMap(std::vector<K> splitKeys, V_forward&& val)
+			:
+				m_splitKeys(std::move(splitKeys)),
+				m_valBegin(std::forward<V_forward>(val)),
+				m_shards(std::make_unique<Shard[]>(m_splitKeys.size() + 1))
+			{
+				assert(std::adjacent_find(m_splitKeys.begin(), m_splitKeys.end(), [](const K& lhs, const K& rhs) { return !(lhs < rhs); }) == m_splitKeys.end());
+
+				for (std::size_t i = 0; i < shardCount(); ++i)
+				{
+					m_shards[i].map = IntervalMap<K, V, Storage>(m_valBegin);
+				}
+			}
+
+			ShardedIntervalMap(const ShardedIntervalMap&) = delete;
+			ShardedIntervalMap& operator=(const ShardedIntervalMap&) = delete;
+
+		public:
+
+			template<typename V_forward>
+			void insert(const K& keyBegin, const K& keyEnd, V_forward&& val)
+			{
+				if (!(keyBegin < keyEnd)) return;
+
+				const std::size_t first = shardOf(keyBegin);
+				const std::size_t last = shardOf(keyEnd, true);
+
+				if (first == last)
+				{
+					std::unique_lock lock(m_shards[first].mutex);
+					m_shards[first].map.insert(keyBegin, keyEnd, std::forward<V_forward>(val));
+					return;
+				}
+
+				// Ascending lock order: writers crossing the same shards cannot deadlock
+				std::vector<std::unique_lock<std::shared_mutex>> locks;
+				locks.reserve(last - first + 1);
+				for (std::size_t i = first; i <= last; ++i)
+				{
+					locks.emplace_back(m_shards[i].mutex);
+				}
+
+				for (std::size_t i = first; i < last; ++i)
+				{
+					m_shards[i].map.insert((i == first) ? keyBegin : m_splitKeys[i - 1], m_splitKeys[i], val);
+				}
+				m_shards[last].map.insert(m_splitKeys[last - 1], keyEnd, std::forward<V_forward>(val));
+			}
+
+			// By value: the shard lock is released before returning
+			V operator[](const K& key) const
+			{
+				const Shard& shard = m_shards[shardOf(key)];
+				std::shared_lock lock(shard.mutex);
+				return shard.map[key];
+			}
+
+			// Consistent canonical copy of the whole map. Takes every shard lock in shared mode,
+			// so it sees each insertion either entirely or not at all.
+			IntervalMap<K, V, Storage> snapshot() const
+			{
+				std::vector<std::shared_lock<std::shared_mutex>> locks;
+				locks.reserve(shardCount());
+				for (std::size_t i = 0; i < shardCount(); ++i)
+				{
+					locks.emplace_back(m_shards[i].mutex);
+				}
+
+				// Shard content clipped to the shard range, assignSorted() merges the pieces across the edges
+				std::vector<Interval<K, V>> intervals;
+				for (std::size_t i = 0; i < shardCount(); ++i)
+				{
+					const auto& map = m_shards[i].map.getMap();
+					for (auto it = map.begin(); it != map.end() && std::next(it) != map.end(); ++it)
+					{
+						intervals.push_back({ it->first, std::next(it)->first, it->second });
+					}
+				}
+
+				IntervalMap<K, V, Storage> merged(m_valBegin);
+				merged.assignSorted(intervals.begin(), intervals.end());
+				return merged;
+			}
+
+			std::size_t shardCount() const
+			{
+				return m_splitKeys.size() + 1;
+			}
+
+			const std::vector<K>& splitKeys() const
+			{
+				return m_splitKeys;
+			}
+
+		private:
+
+			// Shard owning key. As an exclusive end, a key equal to a split key belongs to the shard before it.
+			std::size_t shardOf(const K& key, bool isEnd = false) const
+			{
+				const auto it = isEnd
+					? std::lower_bound(m_splitKeys.begin(), m_splitKeys.end(), key)
+					: std::upper_bound(m_splitKeys.begin(), m_splitKeys.end(), key);
+				return static_cast<std::size_t>(it - m_splitKeys.begin());
+			}
+
+		private:
+
+			const std::vector<K> m_splitKeys;
+			const V m_valBegin;
+			std::unique_ptr<Shard[]> m_shards;
+	};
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "Platform.hpp"
+
+namespace DS
+{
+	// Contiguous array keeping up to N elements in an inline buffer, spilling to the allocator past N.
+	// Only the subset of the std::vector interface FlatMap relies on. Like std::vector, every modification
+	// invalidates iterators; moving a small (inline) vector moves its elements one by one.
+	template <typename T, std::size_t N, typename Allocator = std::allocator<T>>
+	class SmallVector
+	{
+		static_assert(N > 0, "An empty inline buffer is a std::vector");
+
+		private:
+
+			using Traits = std::allocator_traits<Allocator>;
+
+		public:
+
+			using value_type = T;
+			using size_type = std::size_t;
+			using allocator_type = Allocator;
+			using iterator = T*;
+			using const_iterator = const T*;
+
+		public:
+
+			SmallVector() = default;
+
+			explicit SmallVector(const Allocator& alloc)
+			:
+				m_alloc(alloc)
+			{}
+
+			SmallVector(const SmallVector& other)
+			:
+				m_alloc(Traits::select_on_container_copy_construction(other.m_alloc))
+			{
+				reserve(other.m_size);
+				std::uninitialized_copy(other.begin(), other.end(), m_data);
+				m_size = other.m_size;
+			}
+
+			SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+			:
+				m_alloc(std::move(other.m_alloc))
+			{
+				takeFrom(other);
+			}
+
+			SmallVector& operator=(const SmallVector& other)
+			{
+				if (this != &other)
+				{
+					clear();
+					reserve(other.m_size);
+					std::uninitialized_copy(other.begin(), other.end(), m_data);
+					m_size = other.m_size;
+				}
+				return *this;
+			}
+
+			SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+			{
+				if (this != &other)
+				{
+					clear();
+					release();
+					if (!(m_alloc == other.m_alloc) && other.isSpilled())
+					{
+						// Memory of another allocator cannot be adopted
+						reserve(other.m_size);
+						std::uninitialized_move(other.begin(), other.end(), m_data);
+						m_size = other.m_size;
+						other.clear();
+					}
+					else
+					{
+						takeFrom(other);
+					}
+				}
+				return *this;
+			}
+
+			~SmallVector()
+			{
+				clear();
+				release();
+			}
+
+			allocator_type get_allocator() const { return m_alloc; }
+
+		public:
+
+			iterator begin() { return m_data; }
+			iterator end() { return m_data + m_size; }
+			const_iterator begin() const { return m_data; }
+			const_iterator end() const { return m_data + m_size; }
+
+			T* data() { return m_data; }
+			const T* data() const { return m_data; }
+
+			T& operator[](size_type i) { return m_data[i]; }
+			const T& operator[](size_type i) const { return m_data[i]; }
+
+			bool empty() const { return m_size == 0; }
+			size_type size() const { return m_size; }
+			size_type capacity() const { return m_capacity; }
+
+			void clear()
+			{
+				std::destroy(begin(), end());
+				m_size = 0;
+			}
+
+			void reserve(size_type capacity)
+			{
+				if (capacity <= m_capacity) return;
+
+				T* data = Traits::allocate(m_alloc, capacity);
+				std::uninitialized_move(begin(), end(), data);
+				std::destroy(begin(), end());
+				release();
+				m_data = data;
+				m_capacity = capacity;
+			}
+
+			template <typename T_forward>
+			iterator insert(const_iterator pos, T_forward&& val)
+			{
+				const size_type index = static_cast<size_type>(pos - m_data);
+
+				// val may live in this vector, it has to be taken before the elements move
+				T tmp(std::forward<T_forward>(val));
+				if (m_size == m_capacity)
+				{
+					reserve(2 * m_capacity);
+				}
+
+				if (index == m_size)
+				{
+					::new (static_cast<void*>(m_data + m_size)) T(std::move(tmp));
+				}
+				else
+				{
+					::new (static_cast<void*>(m_data + m_size)) T(std::move(m_data[m_size - 1]));
+					std::move_backward(m_data + index, m_data + m_size - 1, m_data + m_size);
+					m_data[index] = std::move(tmp);
+				}
+				++m_size;
+				return m_data + index;
+			}
+
+			iterator erase(const_iterator first, const_iterator last)
+			{
+				T* from = m_data + (first - m_data);
+				T* to = m_data + (last - m_data);
+				if (from != to)
+				{
+					T* newEnd = std::move(to, end(), from);
+					std::destroy(newEnd, end());
+					m_size = static_cast<size_type>(newEnd - m_data);
+				}
+				return from;
+			}
+
+		private:
+
+			bool isSpilled() const
+			{
+				return m_data != inlineData();
+			}
+
+			T* inlineData() { return reinterpret_cast<T*>(m_inline); }
+			const T* inlineData() const { return reinterpret_cast<const T*>(m_inline); }
+
+			// Frees the heap buffer, the vector has to be empty
+			void release()
+			{
+				if (isSpilled())
+				{
+					Traits::deallocate(m_alloc, m_data, m_capacity);
+					m_data = inlineData();
+					m_capacity = N;
+				}
+			}
+
+			// Adopts the heap buffer of other, or moves its inline elements. Leaves other empty and inline.
+			void takeFrom(SmallVector& other)
+			{
+				if (other.isSpilled())
+				{
+					m_data = other.m_data;
+					m_capacity = other.m_capacity;
+					m_size = other.m_size;
+					other.m_data = other.inlineData();
+					other.m_capacity = N;
+					other.m_size = 0;
+				}
+				else
+				{
+					std::uninitialized_move(other.begin(), other.end(), m_data);
+					m_size = other.m_size;
+					other.clear();
+				}
+			}
+
+		private:
+
+			alignas(T) std::byte m_inline[N * sizeof(T)];
+			T* m_data = inlineData();
+			size_type m_size = 0;
+			size_type m_capacity = N;
+			DS_NO_UNIQUE_ADDRESS Allocator m_alloc;
+	};
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "IntervalMap.hpp"
+
+namespace DS
+{
+	namespace detail
+	{
+		inline constexpr std::size_t kCacheLine = 64;
+
+		// Hint only, never faults: the address may lie past the end of the array
+		inline void prefetch(std::uintptr_t address)
+		{
+#if defined(_MSC_VER)
+			_mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0);
+#else
+			__builtin_prefetch(reinterpret_cast<const void*>(address));
+#endif
+		}
+
+		template <typename T>
+		struct CacheAlignedAllocator
+		{
+			using value_type = T;
+
+			CacheAlignedAllocator() = default;
+
+			template <typename U>
+			CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+			T* allocate(std::size_t n)
+			{
+				return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(kCacheLine)));
+			}
+
+			void deallocate(T* ptr, std::size_t)
+			{
+				::operator delete(ptr, std::align_val_t(kCacheLine));
+			}
+
+			friend bool operator==(const CacheAlignedAllocator&, const CacheAlignedAllocator&) { return true; }
+		};
+	}
+
+	// Immutable snapshot of an IntervalMap laid out for lookups. Boundary keys are stored in Eytzinger (BFS) order:
+	// the search walks an implicit complete binary tree without branches, and the 16 (for 4-byte keys) descendants
+	// four levels down share one cache line which is prefetched while the current levels are compared.
+	// K and V have to be default constructible. Same operator[] semantics as IntervalMap, including valBegin.
+	template <typename K, typename V>
+	class StaticIntervalMap
+	{
+		private:
+
+			// Nodes of one prefetched line: the descendants of node k at depth log2(kKeysPerLine) start at k * kKeysPerLine
+			static constexpr std::size_t kKeysPerLine = (sizeof(K) < detail::kCacheLine) ? std::bit_floor(detail::kCacheLine / sizeof(K)) : 1;
+
+		public:
+
+			template <typename Storage, typename Allocator, typename Stats>
+			explicit StaticIntervalMap(const IntervalMap<K, V, Storage, Allocator, Stats>& iMap)
+			:
+				m_valBegin(iMap.valBegin()),
+				m_keys(iMap.getMap().size() + 1),
+				m_values(iMap.getMap().size() + 1)
+			{
+				// Slot 0 is unused, so that the children of k are 2k and 2k + 1 and the line of node k * kKeysPerLine is aligned
+				auto it = iMap.getMap().begin();
+				place(1, it);
+			}
+
+		public:
+
+			V const& operator[](K const& key) const
+			{
+				const std::size_t size = m_keys.size();
+				const K* keys = m_keys.data();
+
+				std::size_t k = 1;
+				while (k < size)
+				{
+					detail::prefetch(reinterpret_cast<std::uintptr_t>(keys) + k * kKeysPerLine * sizeof(K));
+					k = 2 * k + !(key < keys[k]);
+				}
+
+				// Bits of k record the turns, 1 for right. The greatest boundary <= key is where the search last turned right.
+				k >>= std::countr_zero(k) + 1;
+				return (k == 0) ? m_valBegin : m_values[k];
+			}
+
+			// Resolves count keys in one call: out[i] = (*this)[keys[i]]
+			void lookupBatch(const K* keys, std::size_t count, V* out) const
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					out[i] = (*this)[keys[i]];
+				}
+			}
+
+			// Number of boundaries
+			std::size_t size() const { return m_keys.size() - 1; }
+			bool empty() const { return size() == 0; }
+
+			const V& valBegin() const { return m_valBegin; }
+
+		private:
+
+			// In-order walk of the implicit tree receives the boundaries in sorted order
+			template <typename It>
+			void place(std::size_t k, It& it)
+			{
+				if (k >= m_keys.size()) return;
+
+				place(2 * k, it);
+				m_keys[k] = it->first;
+				m_values[k] = it->second;
+				++it;
+				place(2 * k + 1, it);
+			}
+
+		private:
+
+			V m_valBegin;
+			std::vector<K, detail::CacheAlignedAllocator<K>> m_keys;
+			std::vector<V> m_values;
+	};
+
+	// Read-mostly maps: build with IntervalMap, then freeze for the lookup phase
+	template <typename K, typename V, typename Storage, typename Allocator, typename Stats>
+	StaticIntervalMap<K, V> freeze(const IntervalMap<K, V, Storage, Allocator, Stats>& iMap)
+	{
+		return StaticIntervalMap<K, V>(iMap);
+	}
+}
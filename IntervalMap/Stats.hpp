@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace DS
+{
+	// Stats policies. IntervalMap calls the hooks of its policy from insert() and operator[];
+	// NoStats has empty ones and no state, so the default map compiles to the same code as without hooks.
+
+	struct NoStats
+	{
+		static constexpr bool kEnabled = false;
+
+		struct Sample {};
+
+		Sample onLookup() const { return {}; }
+		Sample onInsert() const { return {}; }
+		void onBatchInserted(std::size_t) const {}
+		void onBoundariesCreated(std::size_t) const {}
+		void onBoundariesErased(std::size_t) const {}
+	};
+
+	// Latency histogram with power of two buckets: bucket b counts samples of [2^(b - 1), 2^b) nanoseconds
+	inline constexpr std::size_t kLatencyBuckets = 40;
+	using LatencyHistogram = std::array<std::uint64_t, kLatencyBuckets>;
+
+	// Upper bound in nanoseconds of the bucket holding the given quantile of the samples, 0 without samples
+	inline std::uint64_t latencyQuantile(const LatencyHistogram& histogram, double quantile)
+	{
+		std::uint64_t total = 0;
+		for (const std::uint64_t count : histogram) total += count;
+		if (total == 0) return 0;
+
+		const auto rank = static_cast<std::uint64_t>(quantile * static_cast<double>(total - 1));
+		std::uint64_t seen = 0;
+		for (std::size_t b = 0; b < kLatencyBuckets; ++b)
+		{
+			seen += histogram[b];
+			if (seen > rank) return std::uint64_t(1) << b;
+		}
+		return std::uint64_t(1) << (kLatencyBuckets - 1);
+	}
+
+	// Point in time copy of the statistics of one map. The gauges come from the map, the rest from its policy.
+	struct StatsSnapshot
+	{
+		std::uint64_t lookups = 0;
+		std::uint64_t inserts = 0;
+		std::uint64_t boundariesCreated = 0;
+		std::uint64_t boundariesErased = 0;
+
+		std::size_t boundaries = 0;
+		std::size_t bytes = 0; // Estimated, heap owned by K and V excluded
+
+		LatencyHistogram lookupLatency{};
+		LatencyHistogram insertLatency{};
+
+		// Flat export for a monitoring system: sink(name, value) for every counter, gauge and latency quantile
+		template <typename Sink>
+		void exportTo(Sink&& sink) const
+		{
+			sink("lookups_total", static_cast<double>(lookups));
+			sink("inserts_total", static_cast<double>(inserts));
+			sink("boundaries_created_total", static_cast<double>(boundariesCreated));
+			sink("boundaries_erased_total", static_cast<double>(boundariesErased));
+			sink("boundaries", static_cast<double>(boundaries));
+			sink("bytes", static_cast<double>(bytes));
+
+			for (const double quantile : { 0.5, 0.9, 0.99 })
+			{
+				const std::string suffix = std::to_string(static_cast<int>(quantile * 100));
+				sink("lookup_latency_p" + suffix + "_ns", static_cast<double>(latencyQuantile(lookupLatency, quantile)));
+				sink("insert_latency_p" + suffix + "_ns", static_cast<double>(latencyQuantile(insertLatency, quantile)));
+			}
+		}
+	};
+
+	// Counts operations and boundary changes, times one operation of each kind out of 2^SampleShift.
+	// Relaxed atomics: concurrent readers of a map may all count their lookups.
+	// A copy of a map starts with fresh statistics, they describe one object.
+	template <unsigned SampleShift = 6>
+	class CountingStats
+	{
+		private:
+
+			using Clock = std::chrono::steady_clock;
+
+			struct AtomicHistogram
+			{
+				std::array<std::atomic<std::uint64_t>, kLatencyBuckets> buckets{};
+
+				void record(Clock::duration elapsed)
+				{
+					const auto ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+					const std::size_t bucket = std::min<std::size_t>(std::bit_width(ns), kLatencyBuckets - 1);
+					buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+				}
+
+				LatencyHistogram load() const
+				{
+					LatencyHistogram histogram;
+					for (std::size_t b = 0; b < kLatencyBuckets; ++b)
+					{
+						histogram[b] = buckets[b].load(std::memory_order_relaxed);
+					}
+					return histogram;
+				}
+			};
+
+		public:
+
+			static constexpr bool kEnabled = true;
+
+			// Times the operation it lives through, when it was picked as a sample
+			class Sample
+			{
+				public:
+
+					explicit Sample(AtomicHistogram* histogram)
+					:
+						m_histogram(histogram)
+					{
+						if (m_histogram) m_start = Clock::now();
+					}
+
+					Sample(const Sample&) = delete;
+					Sample& operator=(const Sample&) = delete;
+
+					~Sample()
+					{
+						if (m_histogram) m_histogram->record(Clock::now() - m_start);
+					}
+
+				private:
+
+					AtomicHistogram* m_histogram;
+					Clock::time_point m_start;
+			};
+
+		public:
+
+			CountingStats() = default;
+
+			CountingStats(const CountingStats&) {}
+			CountingStats& operator=(const CountingStats&) { return *this; }
+
+		public:
+
+			Sample onLookup() const
+			{
+				return Sample(isSampled(m_lookups) ? &m_lookupLatency : nullptr);
+			}
+
+			Sample onInsert() const
+			{
+				return Sample(isSampled(m_inserts) ? &m_insertLatency : nullptr);
+			}
+
+			// Batches count every interval as an insert, they are not timed
+			void onBatchInserted(std::size_t count) const
+			{
+				m_inserts.fetch_add(count, std::memory_order_relaxed);
+			}
+
+			void onBoundariesCreated(std::size_t count) const
+			{
+				m_created.fetch_add(count, std::memory_order_relaxed);
+			}
+
+			void onBoundariesErased(std::size_t count) const
+			{
+				m_erased.fetch_add(count, std::memory_order_relaxed);
+			}
+
+			StatsSnapshot snapshot() const
+			{
+				StatsSnapshot snapshot;
+				snapshot.lookups = m_lookups.load(std::memory_order_relaxed);
+				snapshot.inserts = m_inserts.load(std::memory_order_relaxed);
+				snapshot.boundariesCreated = m_created.load(std::memory_order_relaxed);
+				snapshot.boundariesErased = m_erased.load(std::memory_order_relaxed);
+				snapshot.lookupLatency = m_lookupLatency.load();
+				snapshot.insertLatency = m_insertLatency.load();
+				return snapshot;
+			}
+
+		private:
+
+			static bool isSampled(std::atomic<std::uint64_t>& counter)
+			{
+				constexpr std::uint64_t kMask = (std::uint64_t(1) << SampleShift) - 1;
+				return (counter.fetch_add(1, std::memory_order_relaxed) & kMask) == 0;
+			}
+
+		private:
+
+			mutable std::atomic<std::uint64_t> m_lookups{ 0 };
+			mutable std::atomic<std::uint64_t> m_inserts{ 0 };
+			mutable std::atomic<std::uint64_t> m_created{ 0 };
+			mutable std::atomic<std::uint64_t> m_erased{ 0 };
+			mutable AtomicHistogram m_lookupLatency;
+			mutable AtomicHistogram m_insertLatency;
+	};
+}
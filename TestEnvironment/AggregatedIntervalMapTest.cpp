@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "AggregatedIntervalMap.hpp"
+#include "IntervalMapTest.hpp"
+
+namespace
+{
+	// What callers did before: walk the pieces of the window
+	template <typename Monoid, typename Map>
+	typename Monoid::value_type aggregateLinearly(const Map& iMap, std::int64_t lo, std::int64_t hi)
+	{
+		auto agg = Monoid::identity();
+		iMap.query(lo, hi, [&agg](const DS::IntervalView<std::int64_t, std::int64_t>& piece)
+		{
+			agg = Monoid::combine(agg, Monoid::segment(piece.keyBegin, piece.keyEnd, piece.val));
+		});
+		return agg;
+	}
+
+	template <template <typename, typename> typename Monoid, typename V>
+	concept MonoidFor = requires { typename Monoid<int, V>::value_type; };
+}
+
+// Without numeric bounds the identity of Min and Max would silently be V{}
+static_assert(MonoidFor<DS::Min, int> && !MonoidFor<DS::Min, std::string>);
+static_assert(MonoidFor<DS::Max, int> && !MonoidFor<DS::Max, std::string>);
+
+TEST(AggregatedIntervalMapTest, WeightedSumIncludesPartialPieces)
+{
+	DS::AggregatedIntervalMap<int, int> iMap(1);
+	iMap.insert(10, 20, 5);
+	iMap.insert(15, 30, 2);
+
+	EXPECT_EQ(iMap.size(), 3);
+	EXPECT_EQ(iMap[14], 5);
+	EXPECT_EQ(iMap[15], 2);
+	EXPECT_EQ(iMap[30], 1);
+
+	// [0, 10) of valBegin 1, [10, 15) of 5, [15, 30) of 2, [30, 40) of 1
+	EXPECT_EQ(iMap.aggregate(0, 40), 10 + 25 + 30 + 10);
+	EXPECT_EQ(iMap.aggregate(12, 17), 3 * 5 + 2 * 2);
+	EXPECT_EQ(iMap.aggregate(16, 18), 2 * 2);
+	EXPECT_EQ(iMap.aggregate(35, 45), 10);
+	EXPECT_EQ(iMap.aggregate(20, 20), 0);
+}
+
+// Int values over int keys: the sum leaves the range of int long before the keys do
+TEST(AggregatedIntervalMapTest, WeightedSumDoesNotOverflow)
+{
+	DS::AggregatedIntervalMap<int, int> iMap(0);
+	iMap.insert(-2000000000, 2000000000, 1000);
+	iMap.insert(0, 10, -5);
+
+	static_assert(std::is_same_v<decltype(iMap.aggregate(0, 1)), std::int64_t>);
+	EXPECT_EQ(iMap.aggregate(-2000000000, 2000000000), std::int64_t(3999999990) * 1000 - 50);
+
+	DS::AggregatedIntervalMap<int, int, DS::WeightedSum<int, int, double>> averaged(0);
+	averaged.insert(-2000000000, 2000000000, 1000);
+	EXPECT_DOUBLE_EQ(averaged.aggregate(-2000000000, 2000000000) / 4e9, 1000.0);
+}
+
+TEST(AggregatedIntervalMapTest, MatchesIntervalMap)
+{
+	using K = std::int64_t;
+	using V = std::int64_t;
+	using Sum = DS::WeightedSum<K, V>;
+	using Min = DS::Min<K, V>;
+	using Max = DS::Max<K, V>;
+	using Count = DS::SegmentCount<K, V>;
+
+	DS::IntervalMap<K, V> expected(0);
+	DS::AggregatedIntervalMap<K, V> sum(0);
+	DS::AggregatedIntervalMap<K, V, Min> min(0);
+	DS::AggregatedIntervalMap<K, V, Max> max(0);
+	DS::AggregatedIntervalMap<K, V, Count> pieces(0);
+
+	const auto intervals = makeRandomIntervals(3000, 2000, 150, 6);
+	for (size_t i = 0; i < intervals.size(); ++i)
+	{
+		const auto& interval = intervals[i];
+		expected.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		sum.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		min.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		max.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		pieces.insert(interval.keyBegin, interval.keyEnd, interval.val);
+
+		if (i % 101 == 0)
+		{
+			for (const auto& window : makeRandomIntervals(50, 2200, 400, 1, static_cast<unsigned>(i)))
+			{
+				const K lo = window.keyBegin - 10;
+				const K hi = window.keyEnd;
+				ASSERT_EQ(sum.aggregate(lo, hi), aggregateLinearly<Sum>(expected, lo, hi));
+				ASSERT_EQ(min.aggregate(lo, hi), aggregateLinearly<Min>(expected, lo, hi));
+				ASSERT_EQ(max.aggregate(lo, hi), aggregateLinearly<Max>(expected, lo, hi));
+				ASSERT_EQ(pieces.aggregate(lo, hi), aggregateLinearly<Count>(expected, lo, hi));
+			}
+		}
+	}
+
+	EXPECT_EQ(sum.size(), expected.getMap().size());
+	expectSameBoundaries(sum.toIntervalMap(), expected);
+
+	const auto copy = sum;
+	EXPECT_EQ(copy.aggregate(-5, 2500), sum.aggregate(-5, 2500));
+	expectSameBoundaries(copy.toIntervalMap(), expected);
+}
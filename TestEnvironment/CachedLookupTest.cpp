@@ -0,0 +1,113 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "CachedLookup.hpp"
+#include "IntervalMapTest.hpp"
+
+TEST(CachedLookupTest, VersionChangesOnWrites)
+{
+	DS::IntervalMap<int, int> iMap(0);
+	auto version = iMap.version();
+
+	iMap.insert(0, 10, 1);
+	EXPECT_NE(iMap.version(), version);
+	version = iMap.version();
+
+	const std::vector<DS::Interval<int, int>> intervals = { { 20, 30, 2 }, { 40, 50, 3 } };
+	iMap.insertBatch(intervals);
+	EXPECT_NE(iMap.version(), version);
+	version = iMap.version();
+
+	iMap.assignSorted(intervals.begin(), intervals.end());
+	EXPECT_NE(iMap.version(), version);
+	version = iMap.version();
+
+	// Same version on both sides before the assignment, the target still has to move on
+	DS::IntervalMap<int, int> copy = iMap;
+	EXPECT_EQ(copy.version(), version);
+	iMap = copy;
+	EXPECT_NE(iMap.version(), version);
+	version = iMap.version();
+
+	DS::IntervalMap<int, int> moved = std::move(copy);
+	EXPECT_NE(copy.version(), moved.version());
+	iMap = std::move(moved);
+	EXPECT_NE(iMap.version(), version);
+}
+
+// Inserts which leave every boundary as it was keep the version, so cached lookups stay valid
+TYPED_TEST(IntervalMapStorageTest, CachedLookupVersionIgnoresNoOpInserts)
+{
+	DS::IntervalMap<int, int, TypeParam> iMap(0);
+	iMap.insert(0, 10, 1);
+	iMap.insert(10, 20, 2);
+	iMap.insert(30, 40, 3);
+	const auto version = iMap.version();
+
+	iMap.insert(5, 5, 7);	// Empty
+	iMap.insert(0, 10, 1);	// Same value over the same range
+	iMap.insert(12, 18, 2);	// Inside a piece of the same value
+	iMap.insert(22, 28, 0);	// Inside a gap
+	iMap.insert(10, 15, 2);	// Starts at a boundary of the same value
+	iMap.inserter().insert(30, 40, 3);
+	EXPECT_EQ(iMap.version(), version);
+
+	iMap.insert(10, 15, 4);
+	EXPECT_NE(iMap.version(), version);
+}
+
+// Walks forwards, backwards and jumps around, with inserts in between which the cursor has to notice
+TYPED_TEST(IntervalMapStorageTest, CachedLookupMatchesOperatorBracket)
+{
+	DS::IntervalMap<int, int, TypeParam> iMap(0);
+	DS::CachedLookup<DS::IntervalMap<int, int, TypeParam>> lookup(iMap);
+	EXPECT_EQ(lookup[3], 0); // Cursor taken on the empty map
+
+	const auto intervals = makeRandomIntervals(400, 1000, 30, 5);
+	for (size_t i = 0; i < intervals.size(); ++i)
+	{
+		const auto& interval = intervals[i];
+		iMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		if (i % 40 != 0) continue;
+
+		for (int key = -5; key < 1040; ++key)
+		{
+			ASSERT_EQ(lookup[key], iMap[key]) << key;
+		}
+		for (int key = 1040; key >= -5; --key)
+		{
+			ASSERT_EQ(lookup[key], iMap[key]) << key;
+		}
+		for (int key = 0; key < 1040; key += 97)
+		{
+			ASSERT_EQ(lookup[key], iMap[key]) << key;
+			ASSERT_EQ(lookup[1040 - key], iMap[1040 - key]) << key;
+		}
+	}
+}
+
+TEST(CachedLookupTest, SequentialScanHitsNeighbours)
+{
+	DS::IntervalMap<int, int> iMap(0);
+	for (int i = 0; i < 100; ++i)
+	{
+		iMap.insert(10 * i, 10 * i + 5, i + 1);
+	}
+
+	auto lookup = DS::cachedLookup(iMap);
+	for (int key = 0; key < 1000; ++key)
+	{
+		EXPECT_EQ(lookup[key], iMap[key]);
+	}
+
+	// The cursor starts before the first boundary and crosses every boundary one piece at a time
+	EXPECT_EQ(lookup.misses(), 0);
+	EXPECT_EQ(lookup.hits(), 1000);
+
+	iMap.insert(500, 600, 7);
+	EXPECT_EQ(lookup[999], iMap[999]);
+	EXPECT_EQ(lookup.misses(), 1);
+}
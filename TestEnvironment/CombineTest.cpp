@@ -0,0 +1,124 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Combine.hpp"
+#include "IntervalMapTest.hpp"
+
+namespace
+{
+	template <typename Storage>
+	DS::IntervalMap<int, int, Storage> makeMap(int valBegin, size_t count, unsigned seed)
+	{
+		DS::IntervalMap<int, int, Storage> iMap(valBegin);
+		for (const auto& interval : makeRandomIntervals(count, 5000, 120, 4, seed))
+		{
+			iMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		}
+		return iMap;
+	}
+
+	template <typename Map>
+	void expectCanonical(const Map& iMap)
+	{
+		const auto& internalMap = iMap.getMap();
+		if (internalMap.empty()) return;
+
+		EXPECT_NE(internalMap.begin()->second, iMap.valBegin());
+		for (auto it = internalMap.begin(); std::next(it) != internalMap.end(); ++it)
+		{
+			EXPECT_NE(it->second, std::next(it)->second);
+		}
+	}
+}
+
+TYPED_TEST(IntervalMapStorageTest, CombineAppliesFunctionPerSegment)
+{
+	const auto lhs = makeMap<TypeParam>(0, 3000, 1);
+	const auto rhs = makeMap<DS::FlatStorage>(1, 2000, 2);
+
+	for (size_t threadCount : { 1, 3, 8 })
+	{
+		const auto sum = DS::combine(lhs, rhs, [](int a, int b) { return std::to_string(a + b); }, threadCount);
+
+		EXPECT_EQ(sum.valBegin(), "1");
+		for (int key = -1; key < 5200; ++key)
+		{
+			ASSERT_EQ(sum[key], std::to_string(lhs[key] + rhs[key])) << "threads " << threadCount << ", key " << key;
+		}
+		expectCanonical(sum);
+	}
+}
+
+TYPED_TEST(IntervalMapStorageTest, OverlayMatchesInsertion)
+{
+	const auto base = makeMap<TypeParam>(0, 3000, 3);
+	const auto top = makeMap<TypeParam>(-1, 500, 4);
+
+	// What the pipeline did before: insert every non-default interval of top
+	auto expected = base;
+	for (const auto& interval : top.intervals())
+	{
+		if (interval.val != top.valBegin())
+		{
+			expected.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		}
+	}
+
+	for (size_t threadCount : { 1, 4 })
+	{
+		const auto merged = DS::overlay(base, top, threadCount);
+		expectSameBoundaries(merged, expected);
+	}
+}
+
+// A functor with a scratch buffer: threads sharing it would overwrite each other's results
+TYPED_TEST(IntervalMapStorageTest, CombineCopiesStatefulFunctionPerThread)
+{
+	const auto lhs = makeMap<TypeParam>(0, 3000, 5);
+	const auto rhs = makeMap<TypeParam>(0, 3000, 6);
+
+	struct Formatter
+	{
+		std::string scratch;
+		std::size_t calls = 0;
+
+		std::string operator()(int a, int b)
+		{
+			++calls;
+			scratch.assign(static_cast<std::size_t>(a + 1), 'x');
+			scratch += std::to_string(b);
+			return scratch;
+		}
+	};
+
+	Formatter formatter;
+	const auto formatted = DS::combine(lhs, rhs, formatter, 8);
+	for (int key = -1; key < 5200; ++key)
+	{
+		ASSERT_EQ(formatted[key], std::string(static_cast<std::size_t>(lhs[key] + 1), 'x') + std::to_string(rhs[key])) << "key " << key;
+	}
+	expectCanonical(formatted);
+
+	// Workers only touched their copies, the caller's object made the valBegin call
+	EXPECT_EQ(formatter.calls, 1);
+}
+
+TEST(CombineTest, EmptyMaps)
+{
+	const DS::IntervalMap<int, int> lhs(2);
+	DS::IntervalMap<int, int> rhs(3);
+
+	EXPECT_TRUE(DS::combine(lhs, rhs, [](int a, int b) { return a * b; }).getMap().empty());
+	EXPECT_EQ(DS::combine(lhs, rhs, [](int a, int b) { return a * b; })[0], 6);
+
+	EXPECT_EQ(DS::combine(lhs, rhs, [](int a, int b) { return a * b; }, 4)[0], 6);
+
+	rhs.insert(5, 10, 4);
+	const auto product = DS::combine(lhs, rhs, [](int a, int b) { return a * b; }, 4);
+	EXPECT_EQ(product[4], 6);
+	EXPECT_EQ(product[5], 8);
+	EXPECT_EQ(product[10], 6);
+	EXPECT_EQ(product.getMap().size(), 2);
+}
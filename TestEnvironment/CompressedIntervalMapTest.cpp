@@ -0,0 +1,71 @@
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "CompressedIntervalMap.hpp"
+#include "IntervalMapTest.hpp"
+
+// Sizes around the block size leave the last block full, partial or with a single key, or no block at all
+TYPED_TEST(IntervalMapStorageTest, CompressedMatchesIntervalMap)
+{
+	for (size_t count : { 0, 1, 2, 31, 32, 33, 64, 65, 1000, 5000 })
+	{
+		DS::IntervalMap<int, int, TypeParam> iMap(0);
+		for (const auto& interval : makeRandomIntervals(count, static_cast<int>(count) * 8, 40, 7, static_cast<unsigned>(count)))
+		{
+			iMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		}
+
+		const DS::CompressedIntervalMap<int, int> compressed(iMap);
+		ASSERT_EQ(compressed.size(), iMap.getMap().size());
+
+		std::vector<int> keys;
+		for (int key = -2; key < static_cast<int>(count) * 8 + 50; ++key)
+		{
+			keys.push_back(key);
+		}
+		std::vector<int> out(keys.size());
+		compressed.lookupBatch(keys.data(), keys.size(), out.data());
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			ASSERT_EQ(out[i], iMap[keys[i]]) << "count " << count << ", key " << keys[i];
+		}
+	}
+}
+
+TEST(CompressedIntervalMapTest, FullKeyRange)
+{
+	// Deltas up to the whole 64 bit range
+	using K = std::int64_t;
+	DS::IntervalMap<K, int> iMap(0);
+	iMap.insert(std::numeric_limits<K>::min(), std::numeric_limits<K>::min() + 1, 1);
+	iMap.insert(-3, 3, 2);
+	iMap.insert(std::numeric_limits<K>::max() - 1, std::numeric_limits<K>::max(), 3);
+
+	const auto compressed = DS::compress(iMap);
+	for (const K key : { std::numeric_limits<K>::min(), std::numeric_limits<K>::min() + 1, K(-4), K(-3), K(2), K(3),
+		std::numeric_limits<K>::max() - 2, std::numeric_limits<K>::max() - 1, std::numeric_limits<K>::max() })
+	{
+		EXPECT_EQ(compressed[key], iMap[key]) << key;
+	}
+}
+
+TEST(CompressedIntervalMapTest, UnderFourBytesPerBoundary)
+{
+	// Dense boundaries with a handful of distinct values
+	DS::IntervalMap<int, int, DS::FlatStorage> iMap(0);
+	std::vector<DS::Interval<int, int>> intervals;
+	for (int i = 0; i < 100000; ++i)
+	{
+		intervals.push_back({ 100 * i, 100 * i + 37 + (i % 50), 1 + i % 16 });
+	}
+	iMap.assignSorted(intervals.begin(), intervals.end());
+
+	const auto compressed = DS::compress(iMap);
+	ASSERT_EQ(compressed.size(), 200000);
+	EXPECT_LT(compressed.memoryBytes(), 4 * compressed.size());
+	EXPECT_EQ(compressed[100 * 777 + 1], 1 + 777 % 16);
+}
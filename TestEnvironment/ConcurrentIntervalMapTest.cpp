@@ -0,0 +1,94 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ConcurrentIntervalMap.hpp"
+
+// Staged changes stay invisible to readers until they are published
+TEST(ConcurrentIntervalMapTest, PublishMakesChangesVisible)
+{
+	DS::ConcurrentIntervalMap<int, std::string> iMap("Default");
+
+	iMap.insert(10, 20, "A");
+	EXPECT_EQ(iMap[15], "Default");
+	EXPECT_EQ(iMap.staged()[15], "A");
+
+	iMap.publish();
+	EXPECT_EQ(iMap[15], "A");
+	EXPECT_EQ(iMap[20], "Default");
+}
+
+// A pinned snapshot keeps its content, the writer waits for it before freeing
+TEST(ConcurrentIntervalMapTest, GuardPinsSnapshot)
+{
+	DS::ConcurrentIntervalMap<int, int> iMap(0);
+	iMap.insert(0, 10, 1);
+	iMap.publish();
+
+	std::atomic<bool> isPublished = false;
+	std::thread writer;
+	{
+		auto guard = iMap.read();
+		writer = std::thread([&]
+		{
+			iMap.insert(0, 10, 2);
+			iMap.publish();
+			isPublished = true;
+		});
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		EXPECT_FALSE(isPublished.load());
+		EXPECT_EQ((*guard)[5], 1);
+	}
+	writer.join();
+
+	EXPECT_TRUE(isPublished.load());
+	EXPECT_EQ(iMap[5], 2);
+}
+
+// Readers must always observe a complete snapshot: every publish rewrites the whole range with one generation
+TEST(ConcurrentIntervalMapTest, ReadersSeeConsistentSnapshots)
+{
+	DS::ConcurrentIntervalMap<int, int> iMap(0);
+	std::atomic<bool> isDone = false;
+	std::atomic<int> inconsistencies = 0;
+
+	std::vector<std::thread> readers;
+	for (int i = 0; i < 4; ++i)
+	{
+		readers.emplace_back([&]
+		{
+			int lastSeen = 0;
+			while (!isDone.load())
+			{
+				auto guard = iMap.read();
+				const int generation = (*guard)[0];
+				if ((*guard)[50] != generation || (*guard)[99] != generation || generation < lastSeen)
+				{
+					++inconsistencies;
+				}
+				lastSeen = generation;
+			}
+		});
+	}
+
+	for (int generation = 1; generation <= 50; ++generation)
+	{
+		iMap.insert(0, 50, generation);
+		iMap.insert(50, 100, generation);
+		iMap.publish();
+		std::this_thread::yield();
+	}
+	isDone = true;
+	for (auto& reader : readers)
+	{
+		reader.join();
+	}
+
+	EXPECT_EQ(inconsistencies.load(), 0);
+	EXPECT_EQ(iMap[99], 50);
+}
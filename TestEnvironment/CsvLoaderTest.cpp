@@ -0,0 +1,110 @@
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "CsvLoader.hpp"
+#include "IntervalMapTest.hpp"
+
+namespace
+{
+	void writeFile(const std::string& path, const std::string& content)
+	{
+		std::ofstream out(path, std::ios::binary);
+		out << content;
+	}
+}
+
+TYPED_TEST(IntervalMapStorageTest, CsvMatchesInsertInFileOrder)
+{
+	const auto intervals = makeRandomIntervals(20000, 50000, 300, 9);
+
+	std::string content;
+	DS::IntervalMap<int, int, TypeParam> expected(0);
+	for (const auto& interval : intervals)
+	{
+		content += std::to_string(interval.keyBegin) + ',' + std::to_string(interval.keyEnd) + ',' + std::to_string(interval.val) + '\n';
+		expected.insert(interval.keyBegin, interval.keyEnd, interval.val);
+	}
+
+	TempPath path("interval_map_load.csv");
+	writeFile(path.str(), content);
+
+	// Small chunks, so that many of them are parsed in parallel and overlaps cross chunk ends
+	DS::CsvOptions options;
+	options.chunkBytes = 4096;
+	options.threadCount = 4;
+
+	DS::IntervalMap<int, int, TypeParam> iMap(0);
+	EXPECT_EQ(DS::loadCsv(iMap, path.str(), options), intervals.size());
+	expectSameBoundaries(iMap, expected);
+}
+
+// A contiguous storage has to be written once per file, not rebuilt once per chunk
+TEST(CsvLoaderTest, AppliesWholeFileAtOnce)
+{
+	const auto intervals = makeRandomIntervals(5000, 20000, 100, 7);
+
+	std::string content;
+	DS::IntervalMap<int, int, DS::FlatStorage> expected(0);
+	for (const auto& interval : intervals)
+	{
+		content += std::to_string(interval.keyBegin) + ',' + std::to_string(interval.keyEnd) + ',' + std::to_string(interval.val) + '\n';
+		expected.insert(interval.keyBegin, interval.keyEnd, interval.val);
+	}
+
+	TempPath path("interval_map_load_once.csv");
+	writeFile(path.str(), content);
+
+	DS::CsvOptions options;
+	options.chunkBytes = 256;
+	options.threadCount = 4;
+
+	DS::IntervalMap<int, int, DS::FlatStorage> iMap(0);
+	auto version = iMap.version();
+	EXPECT_EQ(DS::loadCsv(iMap, path.str(), options), intervals.size());
+	EXPECT_EQ(iMap.version(), version + 1);
+	expectSameBoundaries(iMap, expected);
+
+	// Loading on top of existing boundaries
+	version = iMap.version();
+	EXPECT_EQ(DS::loadCsv(iMap, path.str(), options), intervals.size());
+	EXPECT_EQ(iMap.version(), version + 1);
+	expectSameBoundaries(iMap, expected);
+}
+
+TEST(CsvLoaderTest, FormatDetails)
+{
+	TempPath path("interval_map_format.csv");
+	writeFile(path.str(), "begin;end;value\r\n10;20;first value\r\n\r\n15;+30;second\n-5;0;third");
+
+	DS::CsvOptions options;
+	options.delimiter = ';';
+	options.skipHeader = true;
+
+	DS::IntervalMap<long long, std::string> iMap("");
+	EXPECT_EQ(DS::loadCsv(iMap, path.str(), options), 3);
+	EXPECT_EQ(iMap[-5], "third");
+	EXPECT_EQ(iMap[0], "");
+	EXPECT_EQ(iMap[14], "first value");
+	EXPECT_EQ(iMap[29], "second");
+	EXPECT_EQ(iMap[30], "");
+}
+
+TEST(CsvLoaderTest, RejectsMalformedLines)
+{
+	DS::IntervalMap<int, double> iMap(0.0);
+
+	TempPath path("interval_map_malformed.csv");
+	writeFile(path.str(), "1,2,0.5\n3,x,1\n");
+	EXPECT_THROW(DS::loadCsv(iMap, path.str()), std::runtime_error);
+
+	writeFile(path.str(), "1,2\n");
+	EXPECT_THROW(DS::loadCsv(iMap, path.str()), std::runtime_error);
+
+	EXPECT_THROW(DS::loadCsv(iMap, path.str() + ".missing"), std::runtime_error);
+
+	writeFile(path.str(), "");
+	EXPECT_EQ(DS::loadCsv(iMap, path.str()), 0);
+}
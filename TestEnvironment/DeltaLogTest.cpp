@@ -0,0 +1,108 @@
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "IntervalMapTest.hpp"
+
+TEST(DeltaLogTest, RecordsOnlyChanges)
+{
+	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string> replica("Default");
+	DS::DeltaLog<int, std::string> journal;
+	iMap.attachJournal(&journal);
+
+	iMap.insert(-8, 8, "Custom");
+	EXPECT_EQ(journal.size(), 2);
+	iMap.insert(5, 10, "Other");
+	iMap.insert(0, 3, "Custom"); // No change, nothing recorded
+	EXPECT_EQ(journal.size(), 5);
+
+	replica.applyDelta(journal);
+	expectSameBoundaries(replica, iMap);
+
+	// Shipped logs are dropped, the next one only holds the newer changes
+	journal.clear();
+	iMap.insert(-20, 20, "Default");
+	ASSERT_EQ(journal.size(), 1);
+	EXPECT_EQ(journal.ops()[0].kind, (DS::DeltaLog<int, std::string>::Kind::Erase));
+	EXPECT_EQ(journal.ops()[0].key, -8);
+	EXPECT_EQ(journal.eraseLasts()[0], 10);
+	EXPECT_TRUE(journal.values().empty());
+	replica.applyDelta(journal);
+	EXPECT_TRUE(replica.getMap().empty());
+
+	iMap.attachJournal(nullptr);
+	iMap.insert(0, 1, "Unrecorded");
+	EXPECT_EQ(journal.size(), 1);
+}
+
+TEST(DeltaLogTest, CopiesDoNotRecord)
+{
+	DS::IntervalMap<int, int> iMap(0);
+	DS::DeltaLog<int, int> journal;
+	iMap.attachJournal(&journal);
+
+	DS::IntervalMap<int, int> copy = iMap;
+	copy.insert(0, 10, 1);
+	EXPECT_TRUE(journal.empty());
+
+	iMap = copy;
+	iMap.insert(20, 30, 2);
+	EXPECT_EQ(journal.size(), 2);
+}
+
+// Every write path, replicated in small batches onto a replica of another storage
+TYPED_TEST(IntervalMapStorageTest, DeltaLogReplicaFollowsEveryWritePath)
+{
+	DS::IntervalMap<int, int, TypeParam> iMap(0);
+	DS::IntervalMap<int, int> replica(0);
+	DS::DeltaLog<int, int> journal;
+	iMap.attachJournal(&journal);
+
+	const auto intervals = makeRandomIntervals(2000, 1000, 60, 6);
+	for (size_t i = 0; i < intervals.size(); ++i)
+	{
+		const auto& interval = intervals[i];
+		switch (i % 3)
+		{
+			case 0: iMap.insert(interval.keyBegin, interval.keyEnd, interval.val); break;
+			case 1: iMap.inserter().insert(interval.keyBegin, interval.keyEnd, interval.val); break;
+			case 2: iMap.insertBatch(std::span<const DS::Interval<int, int>>(&intervals[i - 2], 3)); break;
+		}
+
+		if (i % 7 == 0)
+		{
+			replica.applyDelta(journal);
+			journal.clear();
+			expectSameBoundaries(replica, iMap);
+		}
+	}
+
+	const std::vector<DS::Interval<int, int>> sorted = { { 0, 10, 1 }, { 10, 20, 2 }, { 30, 40, 1 } };
+	iMap.assignSorted(sorted.begin(), sorted.end());
+	iMap.insert(5, 35, 3);
+	iMap.assign(intervals.begin(), intervals.begin() + 50);
+	replica.applyDelta(journal);
+	expectSameBoundaries(replica, iMap);
+}
+
+// The journal follows the size of the update, not the one of the map
+TEST(DeltaLogTest, SizeFollowsUpdate)
+{
+	DS::IntervalMap<int, int> iMap(0);
+	for (int i = 0; i < 10000; ++i)
+	{
+		iMap.insert(10 * i, 10 * i + 5, i % 7 + 1);
+	}
+
+	DS::DeltaLog<int, int> journal;
+	iMap.attachJournal(&journal);
+	iMap.insert(12, 13, 9);
+	iMap.insert(4999, 5031, 9);
+	iMap.insert(20003, 20004, 9);
+	EXPECT_LE(journal.size(), 12);
+	EXPECT_LE(journal.values().size(), 8);
+}
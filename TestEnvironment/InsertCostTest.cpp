@@ -0,0 +1,132 @@
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "IntervalMapTest.hpp"
+
+namespace
+{
+	struct Counters
+	{
+		int copies = 0;
+		int moves = 0;
+		int compares = 0;
+	};
+
+	Counters counters;
+
+	// Value counting what insert() does with it
+	struct Tracked
+	{
+		Tracked() = default;
+		Tracked(int id) : id(id) {}
+
+		Tracked(const Tracked& other) : id(other.id) { ++counters.copies; }
+		Tracked(Tracked&& other) noexcept : id(other.id) { ++counters.moves; }
+		Tracked& operator=(const Tracked& other) { id = other.id; ++counters.copies; return *this; }
+		Tracked& operator=(Tracked&& other) noexcept { id = other.id; ++counters.moves; return *this; }
+
+		friend bool operator==(const Tracked& lhs, const Tracked& rhs) { ++counters.compares; return lhs.id == rhs.id; }
+
+		int id = 0;
+	};
+
+	// Costs of one insert of a fresh temporary value
+	template <typename Map>
+	Counters insertCost(Map& iMap, int keyBegin, int keyEnd, int val)
+	{
+		Tracked tracked(val);
+		counters = {};
+		iMap.insert(keyBegin, keyEnd, std::move(tracked));
+		return counters;
+	}
+
+	// [10, 20) -> 1, [20, 30) -> 2, [30, 40) -> 3
+	DS::IntervalMap<int, Tracked> makeSteps()
+	{
+		DS::IntervalMap<int, Tracked> iMap(0);
+		iMap.insert(10, 20, 1);
+		iMap.insert(20, 30, 2);
+		iMap.insert(30, 40, 3);
+		return iMap;
+	}
+
+	void expectCost(const Counters& cost, int copies, int moves, int compares)
+	{
+		EXPECT_EQ(cost.copies, copies);
+		EXPECT_EQ(cost.moves, moves);
+		EXPECT_EQ(cost.compares, compares);
+	}
+}
+
+TEST(InsertCostTest, IntoEmptyMap)
+{
+	DS::IntervalMap<int, Tracked> iMap(0);
+
+	// valBegin continues after keyEnd: the only copy. val is moved into its boundary.
+	expectCost(insertCost(iMap, 10, 20, 1), 1, 1, 1);
+}
+
+TEST(InsertCostTest, SameValueIsFree)
+{
+	auto iMap = makeSteps();
+
+	// Inside one interval, same value: one compare and nothing else
+	expectCost(insertCost(iMap, 12, 18, 1), 0, 0, 1);
+
+	// Over boundaries, same value on both sides: they are erased, no value is touched
+	expectCost(insertCost(iMap, 5, 50, 0), 0, 0, 2);
+	EXPECT_TRUE(iMap.getMap().empty());
+}
+
+TEST(InsertCostTest, SplitsInterval)
+{
+	auto iMap = makeSteps();
+
+	// The value of [20, 30) continues at 26, copied once
+	expectCost(insertCost(iMap, 23, 26, 7), 1, 1, 1);
+	EXPECT_EQ(iMap[25].id, 7);
+	EXPECT_EQ(iMap[26].id, 2);
+}
+
+TEST(InsertCostTest, ReusesBoundaries)
+{
+	auto iMap = makeSteps();
+
+	// Boundaries at both keyBegin and keyEnd: val is move assigned into the one at keyBegin,
+	// the one at keyEnd already holds the right value. Nothing else changes, so the value at keyBegin
+	// is compared as well: a repeated insert must not bump the version.
+	expectCost(insertCost(iMap, 20, 30, 7), 0, 1, 3);
+	EXPECT_EQ(iMap[20].id, 7);
+	EXPECT_EQ(iMap[30].id, 3);
+	EXPECT_EQ(iMap.getMap().size(), 4);
+}
+
+TEST(InsertCostTest, RelocatesLastValue)
+{
+	auto iMap = makeSteps();
+
+	// The node of 30 -> 3 becomes 35 -> 3 without touching its value, the one of 20 is erased
+	expectCost(insertCost(iMap, 15, 35, 7), 0, 1, 2);
+	EXPECT_EQ(iMap[14].id, 1);
+	EXPECT_EQ(iMap[15].id, 7);
+	EXPECT_EQ(iMap[35].id, 3);
+	EXPECT_EQ(iMap[40].id, 0);
+	EXPECT_EQ(iMap.getMap().size(), 4);
+}
+
+TEST(InsertCostTest, FlatStorageCopies)
+{
+	// Moves of a flat storage depend on the shifted tail, copies do not
+	DS::IntervalMap<int, Tracked, DS::FlatStorage> iMap(0);
+	EXPECT_EQ(insertCost(iMap, 10, 20, 1).copies, 1);
+	EXPECT_EQ(insertCost(iMap, 12, 18, 1).copies, 0);
+	EXPECT_EQ(insertCost(iMap, 15, 30, 2).copies, 0);
+	EXPECT_EQ(insertCost(iMap, 5, 12, 3).copies, 0);
+	EXPECT_EQ(insertCost(iMap, 5, 12, 3).compares, 3); // Repeated, found to change nothing
+	EXPECT_EQ(iMap[11].id, 3);
+	EXPECT_EQ(iMap[12].id, 1);
+	EXPECT_EQ(iMap[15].id, 2);
+	EXPECT_EQ(iMap[30].id, 0);
+}
@@ -0,0 +1,106 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "InternedIntervalMap.hpp"
+#include "IntervalMapTest.hpp"
+
+namespace
+{
+	std::string blobOf(int seed)
+	{
+		return "config-blob-" + std::string(64, static_cast<char>('a' + seed % 26)) + std::to_string(seed);
+	}
+
+	// Value built from string literals, counting the conversions
+	struct Label
+	{
+		Label(const char* text)
+		:
+			text(text)
+		{
+			++conversions;
+		}
+
+		bool operator==(const Label&) const = default;
+
+		std::string text;
+		static inline int conversions = 0;
+	};
+
+	struct LabelHash
+	{
+		std::size_t operator()(const Label& label) const { return std::hash<std::string>{}(label.text); }
+	};
+}
+
+// Same canonical boundaries as a map of full values, but one stored copy per distinct value
+TYPED_TEST(IntervalMapStorageTest, InternedMatchesIntervalMap)
+{
+	DS::IntervalMap<int, std::string, TypeParam> expected(blobOf(0));
+	DS::InternedIntervalMap<int, std::string, TypeParam> iMap(blobOf(0));
+
+	for (const auto& interval : makeRandomIntervals(3000, 2000, 60, 8))
+	{
+		expected.insert(interval.keyBegin, interval.keyEnd, blobOf(interval.val));
+		iMap.insert(interval.keyBegin, interval.keyEnd, blobOf(interval.val));
+	}
+
+	EXPECT_LE(iMap.distinctValues(), 8);
+	ASSERT_EQ(iMap.ids().getMap().size(), expected.getMap().size());
+	for (int key = -1; key < 2100; ++key)
+	{
+		ASSERT_EQ(iMap[key], expected[key]) << "key " << key;
+	}
+
+	const auto copy = iMap;
+	EXPECT_EQ(copy[100], expected[100]);
+}
+
+TEST(InternedIntervalMapTest, CompactDropsUnreferencedValues)
+{
+	DS::InternedIntervalMap<int, std::string> iMap("Default");
+
+	iMap.insert(0, 10, "A");
+	iMap.insert(10, 20, "B");
+	iMap.insert(20, 30, "C");
+	iMap.insert(0, 15, "C"); // A is not referenced any more
+	const auto idOfB = iMap.intern("B");
+	ASSERT_EQ(iMap.distinctValues(), 4);
+
+	const auto version = iMap.ids().version();
+	const auto remap = iMap.compact();
+	EXPECT_NE(iMap.ids().version(), version);
+	EXPECT_EQ(iMap.distinctValues(), 3);
+	EXPECT_EQ(remap[1], (DS::InternedIntervalMap<int, std::string>::kDropped));
+	EXPECT_EQ(iMap.valueOf(remap[idOfB]), "B");
+
+	EXPECT_EQ(iMap[-1], "Default");
+	EXPECT_EQ(iMap[5], "C");
+	EXPECT_EQ(iMap[15], "B");
+	EXPECT_EQ(iMap[25], "C");
+	EXPECT_EQ(iMap[30], "Default");
+
+	// The dictionary index follows the renumbering
+	EXPECT_EQ(iMap.intern("C"), remap[3]);
+	iMap.insertId(40, 50, iMap.intern("A"));
+	EXPECT_EQ(iMap[45], "A");
+}
+
+// A value of another type is converted once per call, whether it is new or already interned
+TEST(InternedIntervalMapTest, ConvertsOnce)
+{
+	DS::InternedIntervalMap<int, Label, DS::TreeStorage, std::uint32_t, LabelHash> iMap("Default");
+	EXPECT_EQ(Label::conversions, 1);
+
+	iMap.insert(0, 10, "A");
+	EXPECT_EQ(Label::conversions, 2);
+	iMap.insert(20, 30, "A");
+	EXPECT_EQ(Label::conversions, 3);
+	EXPECT_EQ(iMap.distinctValues(), 2);
+	EXPECT_EQ(iMap[25].text, "A");
+}
@@ -1,26 +1,33 @@
 #include "IntervalMapTest.hpp"
 
 using keyValueTypes = ::testing::Types<
-	std::pair<int, int>,
-	std::pair<int, char>,
-	std::pair<int, float>,
-	std::pair<int, std::vector<int>>,
-	std::pair<int, std::string>
+	MapParams<int, int, DS::TreeStorage>,
+	MapParams<int, char, DS::TreeStorage>,
+	MapParams<int, float, DS::TreeStorage>,
+	MapParams<int, std::vector<int>, DS::TreeStorage>,
+	MapParams<int, std::string, DS::TreeStorage>,
+	MapParams<int, int, DS::FlatStorage>,
+	MapParams<int, char, DS::FlatStorage>,
+	MapParams<int, float, DS::FlatStorage>,
+	MapParams<int, std::vector<int>, DS::FlatStorage>,
+	MapParams<int, std::string, DS::FlatStorage>,
+	MapParams<int, int, DS::SmallStorage<4>>,
+	MapParams<int, std::string, DS::SmallStorage<4>>
 >;
 
 TYPED_TEST_CASE(IntervalMapTest, keyValueTypes);
 
 TYPED_TEST(IntervalMapTest, DefaultValue)
 {
-	using K = typename TypeParam::first_type;
-	using V = typename TypeParam::second_type;
+	using K = typename TypeParam::K;
+	using V = typename TypeParam::V;
 
 	EXPECT_EQ(this->m_iMap[K{}], V{});
 }
 
-TEST(IntervalMapTest, BasicInsertion)
+TYPED_TEST(IntervalMapStorageTest, BasicInsertion)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(2, 8, "Custom");
 
@@ -30,9 +37,9 @@ TEST(IntervalMapTest, BasicInsertion)
 	EXPECT_EQ(iMap[8], "Default");
 }
 
-TEST(IntervalMapTest, ExactOverlapInsertion)
+TYPED_TEST(IntervalMapStorageTest, ExactOverlapInsertion)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(-100, 100, "Custom");
 	iMap.insert(-100, 100, "Overlapped");
@@ -44,9 +51,9 @@ TEST(IntervalMapTest, ExactOverlapInsertion)
 }
 
 // Test overlapping intervals
-TEST(IntervalMapTest, OverlappingIntervals)
+TYPED_TEST(IntervalMapStorageTest, OverlappingIntervals)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(10, 20, "B");
 	iMap.insert(15, 25, "C");
@@ -59,9 +66,9 @@ TEST(IntervalMapTest, OverlappingIntervals)
 }
 
 // Test inserting a nested interval
-TEST(IntervalMapTest, NestedIntervals)
+TYPED_TEST(IntervalMapStorageTest, NestedIntervals)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(10, 30, "B");
 	iMap.insert(15, 25, "C");
@@ -75,9 +82,9 @@ TEST(IntervalMapTest, NestedIntervals)
 }
 
 // Test inserting an interval that spans across an existing one
-TEST(IntervalMapTest, SpanningInterval)
+TYPED_TEST(IntervalMapStorageTest, SpanningInterval)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(10, 20, "B");
 	iMap.insert(5, 25, "C");
@@ -90,9 +97,9 @@ TEST(IntervalMapTest, SpanningInterval)
 }
 
 // Test edge case: inserting an empty interval (start == end)
-TEST(IntervalMapTest, EmptyInterval)
+TYPED_TEST(IntervalMapStorageTest, EmptyInterval)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(10, 10, "B");
 	EXPECT_EQ(iMap[9], "Default");  // Should remain default
@@ -101,9 +108,9 @@ TEST(IntervalMapTest, EmptyInterval)
 }
 
 // Test assigning multiple disjoint intervals
-TEST(IntervalMapTest, MultipleDisjointIntervals)
+TYPED_TEST(IntervalMapStorageTest, MultipleDisjointIntervals)
 {
-	DS::IntervalMap<int, std::string> iMap("A");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("A");
 
 	iMap.insert(5, 10, "B");
 	iMap.insert(15, 20, "C");
@@ -117,9 +124,9 @@ TEST(IntervalMapTest, MultipleDisjointIntervals)
 }
 
 // Test clearing an interval by reassigning default value
-TEST(IntervalMapTest, ClearInterval)
+TYPED_TEST(IntervalMapStorageTest, ClearInterval)
 {
-	DS::IntervalMap<int, std::string> iMap("A");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("A");
 
 	iMap.insert(10, 20, "B");
 	iMap.insert(10, 20, "A");
@@ -130,9 +137,9 @@ TEST(IntervalMapTest, ClearInterval)
 }
 
 // Test assigning interval with same value as default (should have no effect)
-TEST(IntervalMapTest, AssignDefaultValue)
+TYPED_TEST(IntervalMapStorageTest, AssignDefaultValue)
 {
-	DS::IntervalMap<int, std::string> iMap("A");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("A");
 
 	iMap.insert(10, 20, "A");
 	EXPECT_EQ(iMap[9], "A");
@@ -141,9 +148,9 @@ TEST(IntervalMapTest, AssignDefaultValue)
 }
 
 // Test for adjacent intervals: intervals that touch but do not overlap.
-TEST(IntervalMapTest, AdjacentIntervals)
+TYPED_TEST(IntervalMapStorageTest, AdjacentIntervals)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 	iMap.insert(10, 20, "A");
 	iMap.insert(20, 30, "B");
 
@@ -157,9 +164,9 @@ TEST(IntervalMapTest, AdjacentIntervals)
 
 // Test inserting an interval that covers nearly the entire range of int values.
 // Note: The interval is [min, max) so the key equal to max should return default.
-TEST(IntervalMapTest, FullRangeInterval)
+TYPED_TEST(IntervalMapStorageTest, FullRangeInterval)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 	iMap.insert(std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), "Full");
 
 	EXPECT_EQ(iMap[std::numeric_limits<int>::min()], "Full");
@@ -169,9 +176,9 @@ TEST(IntervalMapTest, FullRangeInterval)
 }
 
 // Test overlapping intervals with the same starting boundary.
-TEST(IntervalMapTest, OverlappingSameStart)
+TYPED_TEST(IntervalMapStorageTest, OverlappingSameStart)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 	iMap.insert(10, 20, "A");
 	iMap.insert(10, 15, "B");
 
@@ -184,9 +191,9 @@ TEST(IntervalMapTest, OverlappingSameStart)
 }
 
 // Test multiple overlapping intervals inserted sequentially.
-TEST(IntervalMapTest, MultipleOverlappingIntervals)
+TYPED_TEST(IntervalMapStorageTest, MultipleOverlappingIntervals)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(10, 30, "A");
 	iMap.insert(20, 40, "B");
@@ -210,9 +217,9 @@ TEST(IntervalMapTest, MultipleOverlappingIntervals)
 }
 
 // Test multiple insertions where a subsequent insertion reassigns part of an interval back to the default value.
-TEST(IntervalMapTest, MultipleInsertionsAndReversions)
+TYPED_TEST(IntervalMapStorageTest, MultipleInsertionsAndReversions)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(10, 20, "A");
 	iMap.insert(15, 25, "B");
@@ -236,9 +243,9 @@ TEST(IntervalMapTest, MultipleInsertionsAndReversions)
 }
 
 // Test that an IntervalMap with no insertions returns the default value for any key.
-TEST(IntervalMapTest, EmptyMapInitialState)
+TYPED_TEST(IntervalMapStorageTest, EmptyMapInitialState)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Without any insertions, every key should yield the default value.
 	EXPECT_EQ(iMap[-100], "Default");
@@ -248,9 +255,9 @@ TEST(IntervalMapTest, EmptyMapInitialState)
 
 // Test inserting into an empty internal map.
 // After the first insertion, the correct segments should be set.
-TEST(IntervalMapTest, InsertIntoEmptyMap)
+TYPED_TEST(IntervalMapStorageTest, InsertIntoEmptyMap)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// m_map is initially empty; inserting an interval should update it.
 	iMap.insert(50, 100, "Custom");
@@ -266,9 +273,9 @@ TEST(IntervalMapTest, InsertIntoEmptyMap)
 }
 
 // Test that inserting an interval with the same value as the default into an empty map has no effect.
-TEST(IntervalMapTest, InsertDefaultValueIntoEmptyMap)
+TYPED_TEST(IntervalMapStorageTest, InsertDefaultValueIntoEmptyMap)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Attempt to insert an interval with the default value.
 	iMap.insert(50, 100, "Default");
@@ -282,9 +289,9 @@ TEST(IntervalMapTest, InsertDefaultValueIntoEmptyMap)
 }
 
 // Test inserting into an empty map
-TEST(IntervalMapTest, InsertIntoEmptyMap2)
+TYPED_TEST(IntervalMapStorageTest, InsertIntoEmptyMap2)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Insert the first interval into an empty map
 	iMap.insert(5, 15, "First");
@@ -297,9 +304,9 @@ TEST(IntervalMapTest, InsertIntoEmptyMap2)
 }
 
 // Test inserting a single interval that covers the entire range of int values into an empty map
-TEST(IntervalMapTest, InsertFullRangeIntoEmptyMap)
+TYPED_TEST(IntervalMapStorageTest, InsertFullRangeIntoEmptyMap)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Insert an interval that covers the entire range of int values
 	iMap.insert(std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), "Full");
@@ -311,9 +318,9 @@ TEST(IntervalMapTest, InsertFullRangeIntoEmptyMap)
 }
 
 // Test inserting an interval with the same start and end into an empty map
-TEST(IntervalMapTest, InsertEmptyIntervalIntoEmptyMap)
+TYPED_TEST(IntervalMapStorageTest, InsertEmptyIntervalIntoEmptyMap)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Insert an empty interval (start == end)
 	iMap.insert(10, 10, "Empty");
@@ -324,9 +331,9 @@ TEST(IntervalMapTest, InsertEmptyIntervalIntoEmptyMap)
 }
 
 // Test inserting an interval that starts and ends at the same boundary into an empty map
-TEST(IntervalMapTest, InsertSinglePointIntervalIntoEmptyMap)
+TYPED_TEST(IntervalMapStorageTest, InsertSinglePointIntervalIntoEmptyMap)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Insert an interval that starts and ends at the same boundary
 	iMap.insert(10, 11, "SinglePoint");
@@ -337,9 +344,9 @@ TEST(IntervalMapTest, InsertSinglePointIntervalIntoEmptyMap)
 }
 
 // Test inserting an interval that starts at the minimum int value into an empty map
-TEST(IntervalMapTest, InsertMinValueIntervalIntoEmptyMap)
+TYPED_TEST(IntervalMapStorageTest, InsertMinValueIntervalIntoEmptyMap)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Insert an interval that starts at the minimum int value
 	iMap.insert(std::numeric_limits<int>::min(), 0, "MinToZero");
@@ -350,9 +357,9 @@ TEST(IntervalMapTest, InsertMinValueIntervalIntoEmptyMap)
 }
 
 // Test inserting an interval that ends at the maximum int value into an empty map
-TEST(IntervalMapTest, InsertMaxValueIntervalIntoEmptyMap)
+TYPED_TEST(IntervalMapStorageTest, InsertMaxValueIntervalIntoEmptyMap)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Insert an interval that ends at the maximum int value
 	iMap.insert(0, std::numeric_limits<int>::max(), "ZeroToMax");
@@ -364,9 +371,9 @@ TEST(IntervalMapTest, InsertMaxValueIntervalIntoEmptyMap)
 }
 
 // Test inserting an interval that starts and ends at the same boundary (minimum int value) into an empty map
-TEST(IntervalMapTest, InsertMinValueSinglePointIntervalIntoEmptyMap)
+TYPED_TEST(IntervalMapStorageTest, InsertMinValueSinglePointIntervalIntoEmptyMap)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Insert an interval that starts and ends at the minimum int value
 	iMap.insert(std::numeric_limits<int>::min(), std::numeric_limits<int>::min() + 1, "MinPoint");
@@ -377,9 +384,9 @@ TEST(IntervalMapTest, InsertMinValueSinglePointIntervalIntoEmptyMap)
 }
 
 // Test inserting an interval that starts and ends at the same boundary (maximum int value) into an empty map
-TEST(IntervalMapTest, InsertMaxValueSinglePointIntervalIntoEmptyMap)
+TYPED_TEST(IntervalMapStorageTest, InsertMaxValueSinglePointIntervalIntoEmptyMap)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Insert an interval that starts and ends at the maximum int value
 	iMap.insert(std::numeric_limits<int>::max() - 1, std::numeric_limits<int>::max(), "MaxPoint");
@@ -390,9 +397,9 @@ TEST(IntervalMapTest, InsertMaxValueSinglePointIntervalIntoEmptyMap)
 }
 
 // Test that a newly constructed IntervalMap is in canonical form.
-TEST(IntervalMapTest, CanonicalFormInitial)
+TYPED_TEST(IntervalMapStorageTest, CanonicalFormInitial)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	const auto& internalMap = iMap.getMap();
 	// For canonical form, no two consecutive map entries should have the same value.
@@ -405,9 +412,9 @@ TEST(IntervalMapTest, CanonicalFormInitial)
 }
 
 // Test that after a single insertion into an empty map the canonical form is preserved.
-TEST(IntervalMapTest, CanonicalFormAfterSingleInsertion)
+TYPED_TEST(IntervalMapStorageTest, CanonicalFormAfterSingleInsertion)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Insert an interval that modifies a segment.
 	iMap.insert(50, 100, "Custom");
@@ -423,9 +430,9 @@ TEST(IntervalMapTest, CanonicalFormAfterSingleInsertion)
 }
 
 // Test that after multiple overlapping insertions the canonical form is maintained.
-TEST(IntervalMapTest, CanonicalFormAfterMultipleOverlaps)
+TYPED_TEST(IntervalMapStorageTest, CanonicalFormAfterMultipleOverlaps)
 {
-	DS::IntervalMap<int, std::string> iMap("A");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("A");
 
 	// Create several overlapping intervals that could lead to redundant boundaries if not merged.
 	iMap.printAsLine();
@@ -449,9 +456,9 @@ TEST(IntervalMapTest, CanonicalFormAfterMultipleOverlaps)
 }
 
 // Test if the map is in canonical form after a single insertion
-TEST(IntervalMapTest, CanonicalFormAfterSingleInsertion2)
+TYPED_TEST(IntervalMapStorageTest, CanonicalFormAfterSingleInsertion2)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(10, 20, "A");
 
@@ -464,9 +471,9 @@ TEST(IntervalMapTest, CanonicalFormAfterSingleInsertion2)
 }
 
 // Test if the map is in canonical form after inserting adjacent intervals with the same value
-TEST(IntervalMapTest, CanonicalFormAfterAdjacentInsertionsSameValue)
+TYPED_TEST(IntervalMapStorageTest, CanonicalFormAfterAdjacentInsertionsSameValue)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(10, 20, "A");
 	iMap.insert(20, 30, "A"); // Adjacent interval with the same value
@@ -480,9 +487,9 @@ TEST(IntervalMapTest, CanonicalFormAfterAdjacentInsertionsSameValue)
 }
 
 // Test if the map is in canonical form after inserting overlapping intervals with the same value
-TEST(IntervalMapTest, CanonicalFormAfterOverlappingInsertionsSameValue)
+TYPED_TEST(IntervalMapStorageTest, CanonicalFormAfterOverlappingInsertionsSameValue)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(10, 20, "A");
 	iMap.insert(15, 25, "A"); // Overlapping interval with the same value
@@ -496,9 +503,9 @@ TEST(IntervalMapTest, CanonicalFormAfterOverlappingInsertionsSameValue)
 }
 
 // Test if the map is in canonical form after inserting intervals that revert to the default value
-TEST(IntervalMapTest, CanonicalFormAfterRevertingToDefault)
+TYPED_TEST(IntervalMapStorageTest, CanonicalFormAfterRevertingToDefault)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(10, 20, "A");
 	iMap.insert(15, 25, "Default"); // Revert part of the interval to default
@@ -513,9 +520,9 @@ TEST(IntervalMapTest, CanonicalFormAfterRevertingToDefault)
 }
 
 // Test if the map is in canonical form after inserting an interval that spans multiple existing intervals
-TEST(IntervalMapTest, CanonicalFormAfterSpanningInsertion)
+TYPED_TEST(IntervalMapStorageTest, CanonicalFormAfterSpanningInsertion)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(10, 20, "A");
 	iMap.insert(30, 40, "B");
@@ -532,9 +539,9 @@ TEST(IntervalMapTest, CanonicalFormAfterSpanningInsertion)
 }
 
 // Test if the map is in canonical form after inserting an interval that covers the entire range
-TEST(IntervalMapTest, CanonicalFormAfterFullRangeInsertion)
+TYPED_TEST(IntervalMapStorageTest, CanonicalFormAfterFullRangeInsertion)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), "Full");
 
@@ -547,9 +554,9 @@ TEST(IntervalMapTest, CanonicalFormAfterFullRangeInsertion)
 }
 
 // Test if the map is in canonical form after inserting an empty interval
-TEST(IntervalMapTest, CanonicalFormAfterEmptyIntervalInsertion)
+TYPED_TEST(IntervalMapStorageTest, CanonicalFormAfterEmptyIntervalInsertion)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(10, 10, "A"); // Empty interval
 
@@ -561,9 +568,9 @@ TEST(IntervalMapTest, CanonicalFormAfterEmptyIntervalInsertion)
 }
 
 // Test if the map is in canonical form after inserting multiple intervals and reverting some to default
-TEST(IntervalMapTest, CanonicalFormAfterMultipleInsertionsAndRevertions)
+TYPED_TEST(IntervalMapStorageTest, CanonicalFormAfterMultipleInsertionsAndRevertions)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	iMap.insert(10, 20, "A");
 	iMap.insert(15, 25, "B");
@@ -587,9 +594,9 @@ TEST(IntervalMapTest, CanonicalFormAfterMultipleInsertionsAndRevertions)
 // the first boundary in m_map, no invalid iterator is dereferenced.
 // For example, after an interval insertion starting at 5, inserting one with keyEnd < 5
 // should work correctly.
-TEST(IntervalMapTest, RightBoundaryLookup)
+TYPED_TEST(IntervalMapStorageTest, RightBoundaryLookup)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Insert an interval so that m_map gets an entry (at key 5)
 	iMap.insert(5, 10, "A");
@@ -618,9 +625,9 @@ TEST(IntervalMapTest, RightBoundaryLookup)
 // This test checks that the internal m_map remains canonical after assignments.
 // Specifically, inserting an interval with a value that is already in effect should not
 // add unnecessary boundaries.
-TEST(IntervalMapTest, CanonicalRepresentation)
+TYPED_TEST(IntervalMapStorageTest, CanonicalRepresentation)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Initially, m_map should be empty
 	EXPECT_TRUE(iMap.m_map.empty());
@@ -639,9 +646,9 @@ TEST(IntervalMapTest, CanonicalRepresentation)
 // Although we cannot directly verify the use of iterator hints,
 // this test performs several insertions (in non-sorted order) and checks that
 // the overall interval mapping is as expected.
-TEST(IntervalMapTest, IteratorHintsConsistency)
+TYPED_TEST(IntervalMapStorageTest, IteratorHintsConsistency)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Insert intervals in an order that challenges internal iterator hints
 	iMap.insert(30, 40, "X");
@@ -669,9 +676,9 @@ TEST(IntervalMapTest, IteratorHintsConsistency)
 // This test verifies that intervals touching at their boundaries are handled
 // correctly without redundant boundaries. It also checks that an insertion that
 // does not change the value is correctly ignored.
-TEST(IntervalMapTest, OffByOneBoundaries)
+TYPED_TEST(IntervalMapStorageTest, OffByOneBoundaries)
 {
-	DS::IntervalMap<int, std::string> iMap("Default");
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
 
 	// Insert two adjacent intervals.
 	iMap.insert(10, 20, "A");
@@ -702,3 +709,367 @@ TEST(IntervalMapTest, OffByOneBoundaries)
 	EXPECT_EQ(iMap[14], "Default");
 	EXPECT_EQ(iMap[15], "A");
 }
+
+// Both storages have to end up with exactly the same boundaries after the same sequence of insertions
+TEST(IntervalMapTest, StoragesProduceSameBoundaries)
+{
+	DS::IntervalMap<int, int, DS::TreeStorage> treeMap(0);
+	DS::IntervalMap<int, int, DS::FlatStorage> flatMap(0);
+
+	for (const auto& interval : makeRandomIntervals(2000, 500, 50, 4))
+	{
+		treeMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		flatMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+	}
+
+	expectSameBoundaries(treeMap, flatMap);
+	for (int key = -1; key < 560; ++key)
+	{
+		EXPECT_EQ(treeMap[key], flatMap[key]);
+	}
+}
+
+// A value which fails to copy must leave the flat arrays as they were, like std::map does
+TEST(IntervalMapTest, FlatMapInsertionIsStrong)
+{
+	struct Fragile
+	{
+		Fragile(int v) : val(v) {}
+		Fragile(const Fragile& other) : val(other.val) { if (other.val < 0) throw std::runtime_error("copy"); }
+		Fragile& operator=(const Fragile&) = default;
+
+		int val;
+	};
+
+	DS::FlatMap<int, Fragile> map;
+	map.emplace_hint(map.end(), 10, Fragile(1));
+	map.emplace_hint(map.end(), 30, Fragile(3));
+
+	const Fragile broken(-1);
+	EXPECT_THROW(map.emplace_hint(map.begin(), 20, broken), std::runtime_error);
+	EXPECT_THROW(map.insert_or_assign(map.begin(), 0, broken), std::runtime_error);
+
+	ASSERT_EQ(map.keys().size(), 2);
+	ASSERT_EQ(map.values().size(), 2);
+	EXPECT_EQ(map.keys()[0], 10);
+	EXPECT_EQ(map.keys()[1], 30);
+	EXPECT_EQ(map.values()[1].val, 3);
+}
+
+// Batched lookups must answer exactly like operator[], including keys before the first boundary
+TYPED_TEST(IntervalMapStorageTest, LookupBatchMatchesPointLookups)
+{
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
+	iMap.insert(10, 20, "A");
+	iMap.insert(15, 25, "B");
+	iMap.insert(40, 50, "C");
+	iMap.insert(std::numeric_limits<int>::max() - 1, std::numeric_limits<int>::max(), "Max");
+
+	std::vector<int> keys;
+	for (int key = 0; key < 60; key += 3)
+	{
+		keys.push_back(key);
+	}
+	keys.push_back(std::numeric_limits<int>::min());
+	keys.push_back(std::numeric_limits<int>::max() - 1);
+	keys.push_back(std::numeric_limits<int>::max());
+
+	std::vector<std::string> out(keys.size());
+	iMap.lookupBatch(keys.data(), keys.size(), out.data());
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		EXPECT_EQ(out[i], iMap[keys[i]]) << "key " << keys[i];
+	}
+
+	std::sort(keys.begin(), keys.end());
+	std::vector<std::string> sortedOut(keys.size());
+	iMap.lookupBatchSorted(keys.data(), keys.size(), sortedOut.data());
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		EXPECT_EQ(sortedOut[i], iMap[keys[i]]) << "key " << keys[i];
+	}
+
+	// Batches too small to pay for copying the boundaries of a tree are searched key by key
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		std::string single;
+		iMap.lookupBatch(&keys[i], 1, &single);
+		EXPECT_EQ(single, iMap[keys[i]]) << "key " << keys[i];
+		iMap.lookupBatchSorted(&keys[i], 1, &single);
+		EXPECT_EQ(single, iMap[keys[i]]) << "key " << keys[i];
+	}
+}
+
+// Arithmetic keys go through the branchless/vectorized kernels, check them against operator[] on every size
+TYPED_TEST(IntervalMapStorageTest, LookupBatchArithmeticKeys)
+{
+	DS::IntervalMap<int, int, TypeParam> intMap(-1);
+	DS::IntervalMap<float, int, TypeParam> floatMap(-1);
+
+	std::vector<int> intKeys;
+	std::vector<float> floatKeys;
+	for (int key = -5; key < 200; ++key)
+	{
+		intKeys.push_back(key);
+		floatKeys.push_back(key * 0.5f);
+	}
+
+	std::vector<int> intOut(intKeys.size());
+	std::vector<int> floatOut(floatKeys.size());
+	for (int size = 0; size < 40; ++size)
+	{
+		intMap.insert(size * 4, size * 4 + 3, size);
+		floatMap.insert(size * 2.0f, size * 2.0f + 1.5f, size);
+
+		intMap.lookupBatch(intKeys.data(), intKeys.size(), intOut.data());
+		floatMap.lookupBatch(floatKeys.data(), floatKeys.size(), floatOut.data());
+		for (size_t i = 0; i < intKeys.size(); ++i)
+		{
+			ASSERT_EQ(intOut[i], intMap[intKeys[i]]) << "key " << intKeys[i];
+			ASSERT_EQ(floatOut[i], floatMap[floatKeys[i]]) << "key " << floatKeys[i];
+		}
+
+		intMap.lookupBatchSorted(intKeys.data(), intKeys.size(), intOut.data());
+		for (size_t i = 0; i < intKeys.size(); ++i)
+		{
+			ASSERT_EQ(intOut[i], intMap[intKeys[i]]) << "key " << intKeys[i];
+		}
+	}
+}
+
+// Bulk load from sorted intervals must give the same canonical boundaries as inserting them one by one
+TYPED_TEST(IntervalMapStorageTest, AssignSortedMatchesInsert)
+{
+	const std::vector<DS::Interval<int, std::string>> intervals = {
+		{ -20, -10, "Default" }, // Same as the begin value, no boundary
+		{ -10, -5, "A" },
+		{ -5, 0, "A" },          // Adjacent with same value, merged
+		{ 0, 5, "B" },
+		{ 10, 20, "B" },         // Gap before it
+		{ 20, 30, "Default" },   // Adjacent, back to the begin value
+		{ 40, 40, "Empty" },     // Ignored
+		{ 40, 50, "C" }
+	};
+
+	DS::IntervalMap<int, std::string, TypeParam> expected("Default");
+	for (const auto& interval : intervals)
+	{
+		expected.insert(interval.keyBegin, interval.keyEnd, interval.val);
+	}
+
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
+	iMap.insert(-100, 100, "Overwritten");
+	iMap.assignSorted(intervals.begin(), intervals.end());
+
+	expectSameBoundaries(iMap, expected);
+	EXPECT_EQ(iMap.getMap().size(), 7); // Boundaries: -10, 0, 5, 10, 20, 40, 50
+}
+
+// Unsorted overlapping intervals: the later interval wins, exactly like sequential insert() calls
+TYPED_TEST(IntervalMapStorageTest, AssignResolvesLastWriterWins)
+{
+	const auto intervals = makeRandomIntervals(3000, 1000, 60, 5);
+
+	DS::IntervalMap<int, int, TypeParam> expected(0);
+	for (const auto& interval : intervals)
+	{
+		expected.insert(interval.keyBegin, interval.keyEnd, interval.val);
+	}
+
+	DS::IntervalMap<int, int, TypeParam> iMap(0);
+	iMap.assign(intervals.begin(), intervals.end());
+
+	expectSameBoundaries(iMap, expected);
+}
+
+// Splitting the key space between threads must not change the resolved segments
+TEST(IntervalMapTest, ParallelLastWriterWinsResolution)
+{
+	const auto intervals = makeRandomIntervals(20000, 100000, 500, 7);
+
+	const auto serial = DS::detail::resolveLastWriterWins<int, int>(intervals, 1);
+	const auto parallel = DS::detail::resolveLastWriterWins<int, int>(intervals, 4);
+
+	ASSERT_EQ(serial.size(), parallel.size());
+	for (size_t i = 0; i < serial.size(); ++i)
+	{
+		EXPECT_EQ(serial[i].keyBegin, parallel[i].keyBegin);
+		EXPECT_EQ(serial[i].keyEnd, parallel[i].keyEnd);
+		EXPECT_EQ(serial[i].source, parallel[i].source);
+	}
+}
+
+// Batched insertion has to end up exactly like sequential insert() calls, whatever path the batch size picks
+TYPED_TEST(IntervalMapStorageTest, InsertBatchMatchesSequentialInsert)
+{
+	const auto initial = makeRandomIntervals(2000, 10000, 40, 4, 7);
+
+	for (size_t batchSize : { 0, 1, 3, 50, 5000 })
+	{
+		DS::IntervalMap<int, int, TypeParam> expected(0);
+		DS::IntervalMap<int, int, TypeParam> iMap(0);
+		iMap.assign(initial.begin(), initial.end());
+		expected.assign(initial.begin(), initial.end());
+
+		const auto batch = makeRandomIntervals(batchSize, 10200, 300, 4, static_cast<unsigned>(batchSize));
+		for (const auto& interval : batch)
+		{
+			expected.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		}
+		iMap.insertBatch(batch);
+
+		expectSameBoundaries(iMap, expected);
+	}
+}
+
+// Intervals fully hidden by later ones in the same batch must not leave anything behind
+TYPED_TEST(IntervalMapStorageTest, InsertBatchDropsShadowedIntervals)
+{
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
+	iMap.insert(0, 100, "Base");
+
+	const std::vector<DS::Interval<int, std::string>> batch = {
+		{ 10, 20, "A" },
+		{ 30, 40, "B" },
+		{ 5, 45, "C" },     // Hides A and B
+		{ 60, 70, "D" },
+		{ 65, 70, "Base" }, // Cuts D back to the base value
+		{ 90, 120, "E" }
+	};
+	iMap.insertBatch(batch);
+
+	EXPECT_EQ(iMap[4], "Base");
+	EXPECT_EQ(iMap[5], "C");
+	EXPECT_EQ(iMap[44], "C");
+	EXPECT_EQ(iMap[45], "Base");
+	EXPECT_EQ(iMap[60], "D");
+	EXPECT_EQ(iMap[65], "Base");
+	EXPECT_EQ(iMap[90], "E");
+	EXPECT_EQ(iMap[119], "E");
+	EXPECT_EQ(iMap[120], "Default");
+	EXPECT_EQ(iMap.getMap().size(), 7); // Boundaries: 0, 5, 45, 60, 65, 90, 120
+}
+
+// Every boundary has to come from the memory resource given to the map
+TYPED_TEST(IntervalMapStorageTest, PmrArenaOwnsAllBoundaries)
+{
+	std::byte buffer[16 * 1024];
+	std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+	DS::pmr::IntervalMap<int, int, TypeParam> iMap(0, &arena);
+	for (int i = 0; i < 50; ++i)
+	{
+		iMap.insert(i * 10, i * 10 + 5, i + 1);
+	}
+	iMap.insert(100, 200, 0);
+	iMap.insertBatch(makeRandomIntervals(20, 500, 30, 3));
+
+	// Running out of the arena would have thrown, the null upstream never hands out global memory
+	EXPECT_EQ(iMap.getMap().get_allocator().resource(), &arena);
+
+	DS::IntervalMap<int, int, TypeParam> expected(0);
+	for (int i = 0; i < 50; ++i)
+	{
+		expected.insert(i * 10, i * 10 + 5, i + 1);
+	}
+	expected.insert(100, 200, 0);
+	expected.insertBatch(makeRandomIntervals(20, 500, 30, 3));
+	expectSameBoundaries(iMap, expected);
+}
+
+TYPED_TEST(IntervalMapStorageTest, IntervalsWalkCanonicalForm)
+{
+	DS::IntervalMap<int, std::string, TypeParam> iMap("Default");
+	EXPECT_TRUE(iMap.intervals().empty());
+
+	iMap.insert(2, 5, "A");
+	iMap.insert(8, 10, "B");
+
+	std::vector<std::tuple<int, int, std::string>> walked;
+	for (const auto& [keyBegin, keyEnd, val] : iMap.intervals())
+	{
+		walked.emplace_back(keyBegin, keyEnd, val);
+	}
+
+	const std::vector<std::tuple<int, int, std::string>> expected = {
+		{ 2, 5, "A" }, { 5, 8, "Default" }, { 8, 10, "B" }
+	};
+	EXPECT_EQ(walked, expected);
+}
+
+TYPED_TEST(IntervalMapStorageTest, QueryClipsToWindow)
+{
+	DS::IntervalMap<int, int, TypeParam> iMap(0);
+	for (const auto& interval : makeRandomIntervals(2000, 1000, 40, 5))
+	{
+		iMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+	}
+
+	for (const auto& [lo, hi] : { std::pair{ -50, -10 }, std::pair{ -5, 17 }, std::pair{ 100, 101 }, std::pair{ 300, 700 }, std::pair{ 990, 1200 }, std::pair{ 9, 9 } })
+	{
+		int covered = lo;
+		iMap.query(lo, hi, [&](const DS::IntervalView<int, int>& piece)
+		{
+			// Pieces tile [lo, hi) in order and each carries the value of every key inside it
+			ASSERT_EQ(piece.keyBegin, covered);
+			ASSERT_LT(piece.keyBegin, piece.keyEnd);
+			for (int key = piece.keyBegin; key < piece.keyEnd; ++key)
+			{
+				ASSERT_EQ(iMap[key], piece.val) << "key " << key;
+			}
+			ASSERT_TRUE(piece.keyEnd == hi || iMap[piece.keyEnd] != piece.val);
+			covered = piece.keyEnd;
+		});
+		EXPECT_EQ(covered, std::max(lo, hi));
+	}
+}
+
+// Monotonic appends through an inserter: the time-series pattern
+TYPED_TEST(IntervalMapStorageTest, InserterAppendsKeepCanonicalForm)
+{
+	DS::IntervalMap<int, int, TypeParam> expected(0);
+	DS::IntervalMap<int, int, TypeParam> iMap(0);
+	auto inserter = iMap.inserter();
+
+	for (int i = 0; i < 2000; ++i)
+	{
+		// Adjacent, gapped and repeated values, some overlapping the previous interval
+		const int keyBegin = i * 10 - (i % 3);
+		const int keyEnd = keyBegin + 5 + (i % 7);
+		const int val = (i / 2) % 3;
+
+		expected.insert(keyBegin, keyEnd, val);
+		inserter.insert(keyBegin, keyEnd, val);
+	}
+	expectSameBoundaries(iMap, expected);
+
+	const auto& internalMap = iMap.getMap();
+	EXPECT_NE(internalMap.begin()->second, 0);
+	for (auto it = internalMap.begin(); std::next(it) != internalMap.end(); ++it)
+	{
+		EXPECT_NE(it->second, std::next(it)->second);
+	}
+}
+
+// Localized and far jumps alike end up where insert() puts them
+TYPED_TEST(IntervalMapStorageTest, InserterMatchesInsert)
+{
+	DS::IntervalMap<int, int, TypeParam> expected(0);
+	DS::IntervalMap<int, int, TypeParam> iMap(0);
+	auto inserter = iMap.inserter();
+
+	inserter.insert(5, 5, 1); // Empty interval before anything else
+	for (const auto& interval : makeRandomIntervals(4000, 3000, 50, 4))
+	{
+		expected.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		inserter.insert(interval.keyBegin, interval.keyEnd, interval.val);
+	}
+	int drift = 1500;
+	for (int i = 0; i < 3000; ++i)
+	{
+		drift += (i % 5) * 3 - 6;
+		expected.insert(drift, drift + 4, i % 4);
+		inserter.insert(drift, drift + 4, i % 4);
+	}
+	expectSameBoundaries(iMap, expected);
+}
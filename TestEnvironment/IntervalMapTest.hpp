@@ -3,13 +3,28 @@
 #include <utility>
 
 // STL for test cases
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <memory_resource>
+#include <stdexcept>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include "IntervalMap.hpp"
 
+// Bundles DS::IntervalMap template arguments, so a single type list can cover keys, values and storages
+template <typename K_type, typename V_type, typename Storage_type = DS::TreeStorage>
+struct MapParams
+{
+	using K = K_type;
+	using V = V_type;
+	using Storage = Storage_type;
+};
+
 template <typename T>
 class IntervalMapTest : public ::testing::Test
 {
@@ -19,14 +34,80 @@ class IntervalMapTest : public ::testing::Test
 
 	protected:
 
-		using K = typename T::first_type;
-		using V = typename T::second_type;
+		using K = typename T::K;
+		using V = typename T::V;
+		using Storage = typename T::Storage;
 
 	protected:
 
-		void SetUp() override { m_iMap = DS::IntervalMap<K, V>(V{}); }
+		void SetUp() override { m_iMap = DS::IntervalMap<K, V, Storage>(V{}); }
 
 	protected:
 
-		DS::IntervalMap<K, V> m_iMap;
+		DS::IntervalMap<K, V, Storage> m_iMap;
+};
+
+// Behavioural tests parametrized only by the storage policy, shared by the test files of every map built on one
+template <typename Storage>
+class IntervalMapStorageTest : public ::testing::Test
+{};
+
+using StorageTypes = ::testing::Types<
+	DS::TreeStorage,
+	DS::FlatStorage,
+	DS::SmallStorage<4>
+>;
+
+TYPED_TEST_CASE(IntervalMapStorageTest, StorageTypes);
+
+// Both maps have to hold exactly the same boundaries, whatever their storages are
+template <typename LhsMap, typename RhsMap>
+void expectSameBoundaries(const LhsMap& lhs, const RhsMap& rhs)
+{
+	ASSERT_EQ(lhs.getMap().size(), rhs.getMap().size());
+
+	auto itRhs = rhs.getMap().begin();
+	for (const auto& [key, val] : lhs.getMap())
+	{
+		EXPECT_EQ(key, itRhs->first);
+		EXPECT_EQ(val, itRhs->second);
+		++itRhs;
+	}
+}
+
+// Deterministic pseudo random intervals inside [0, keyRange + maxLength)
+inline std::vector<DS::Interval<int, int>> makeRandomIntervals(size_t count, int keyRange, int maxLength, int valRange, unsigned seed = 42)
+{
+	auto next = [&seed](int range) { seed = seed * 1103515245u + 12345u; return static_cast<int>((seed >> 16) % range); };
+
+	std::vector<DS::Interval<int, int>> intervals;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const int keyBegin = next(keyRange);
+		const int keyEnd = keyBegin + next(maxLength);
+		intervals.push_back({ keyBegin, keyEnd, next(valRange) });
+	}
+	return intervals;
+}
+
+// Temporary file removed with the test
+class TempPath
+{
+	public:
+
+		explicit TempPath(const std::string& name)
+		:
+			m_path((std::filesystem::temp_directory_path() / name).string())
+		{}
+
+		~TempPath()
+		{
+			std::remove(m_path.c_str());
+		}
+
+		const std::string& str() const { return m_path; }
+
+	private:
+
+		std::string m_path;
 };
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "IntervalMapTest.hpp"
+#include "LazyIntervalMap.hpp"
+
+namespace
+{
+	// What callers did before: read the pieces out and insert them back one by one
+	template <typename Map, typename F>
+	void transformEagerly(Map& iMap, int keyBegin, int keyEnd, F f)
+	{
+		std::vector<DS::Interval<int, int>> pieces;
+		iMap.query(keyBegin, keyEnd, [&pieces](const DS::IntervalView<int, int>& piece) { pieces.push_back({ piece.keyBegin, piece.keyEnd, piece.val }); });
+		for (const auto& piece : pieces)
+		{
+			iMap.insert(piece.keyBegin, piece.keyEnd, f(piece.val));
+		}
+	}
+}
+
+TYPED_TEST(IntervalMapStorageTest, LazyTransformRange)
+{
+	DS::LazyIntervalMap<int, std::string, TypeParam> iMap("Default");
+	iMap.insert(10, 20, "A");
+	iMap.transform(15, 30, [](const std::string& val) { return val + "+"; });
+
+	iMap.insert(12, 13, "B");
+	EXPECT_EQ(iMap.pendingCount(), 1);
+	EXPECT_EQ(iMap[9], "Default");
+	EXPECT_EQ(iMap[10], "A");
+	EXPECT_EQ(iMap[12], "B");
+	EXPECT_EQ(iMap[13], "A");
+	EXPECT_EQ(iMap[15], "A+");
+	EXPECT_EQ(iMap[20], "Default+");
+	EXPECT_EQ(iMap[30], "Default");
+	EXPECT_EQ(iMap.pendingCount(), 1);
+
+	using Boundaries = std::vector<std::pair<int, std::string>>;
+	const Boundaries expected = { { 10, "A" }, { 12, "B" }, { 13, "A" }, { 15, "A+" }, { 20, "Default+" }, { 30, "Default" } };
+	EXPECT_EQ(Boundaries(iMap.getMap().begin(), iMap.getMap().end()), expected);
+	EXPECT_EQ(iMap.pendingCount(), 0);
+}
+
+TYPED_TEST(IntervalMapStorageTest, LazyTransformAllRewritesValBegin)
+{
+	DS::LazyIntervalMap<int, int, TypeParam> iMap(0);
+	iMap.insert(10, 20, 1);
+	iMap.insert(30, 40, 0);
+	iMap.transformAll([](int val) { return (val == 0) ? 1 : val; });
+
+	// Everything is 1 now, no boundary is left
+	EXPECT_EQ(iMap[35], 1);
+	EXPECT_EQ(iMap.valBegin(), 1);
+	EXPECT_TRUE(iMap.getMap().empty());
+}
+
+TYPED_TEST(IntervalMapStorageTest, LazyMatchesEagerUpdates)
+{
+	DS::IntervalMap<int, int, TypeParam> expected(0);
+	DS::LazyIntervalMap<int, int, TypeParam> iMap(0);
+
+	const auto intervals = makeRandomIntervals(2000, 1000, 150, 5);
+	for (size_t i = 0; i < intervals.size(); ++i)
+	{
+		const auto& interval = intervals[i];
+		switch (i % 3)
+		{
+			case 0:
+				expected.insert(interval.keyBegin, interval.keyEnd, interval.val);
+				iMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+				break;
+			case 1:
+				transformEagerly(expected, interval.keyBegin, interval.keyEnd, [](int val) { return val + 1; });
+				iMap.transform(interval.keyBegin, interval.keyEnd, [](int val) { return val + 1; });
+				break;
+			default:
+				transformEagerly(expected, interval.keyBegin, interval.keyEnd, [](int val) { return val % 4; });
+				iMap.transform(interval.keyBegin, interval.keyEnd, [](int val) { return val % 4; });
+				break;
+		}
+
+		if (i % 97 == 0)
+		{
+			for (int key = -1; key < 1200; key += 7)
+			{
+				ASSERT_EQ(iMap[key], expected[key]) << "key " << key;
+			}
+		}
+	}
+
+	expectSameBoundaries(iMap.materialize(), expected);
+
+	// Materializing again and continuing from the rebuilt tree
+	iMap.transform(100, 900, [](int val) { return val * 2; });
+	transformEagerly(expected, 100, 900, [](int val) { return val * 2; });
+	expectSameBoundaries(iMap.materialize(), expected);
+}
+
+// Results of materialize() are owned by the caller, later writes do not reach them
+TYPED_TEST(IntervalMapStorageTest, LazyMaterializedMapOutlivesWrites)
+{
+	DS::LazyIntervalMap<int, int, TypeParam> iMap(0);
+	iMap.insert(10, 20, 1);
+	iMap.transform(15, 30, [](int val) { return val + 2; });
+
+	const auto before = iMap.materialize();
+	iMap.insert(0, 40, 5);
+	iMap.transformAll([](int val) { return val * 10; });
+	const auto after = iMap.materialize();
+
+	using Boundaries = std::vector<std::pair<int, int>>;
+	EXPECT_EQ(Boundaries(before.getMap().begin(), before.getMap().end()), (Boundaries{ { 10, 1 }, { 15, 3 }, { 20, 2 }, { 30, 0 } }));
+	EXPECT_EQ(Boundaries(after.getMap().begin(), after.getMap().end()), (Boundaries{ { 0, 50 }, { 40, 0 } }));
+	EXPECT_EQ(after.valBegin(), 0);
+}
+
+// Transforms are not called until a value is read, then once per transform covering it
+TEST(LazyIntervalMapTest, TransformsAreCalledOnRead)
+{
+	constexpr int kBoundaries = 1 << 14;
+	constexpr int kTransforms = 2000;
+
+	DS::LazyIntervalMap<int, int> iMap(0);
+	for (int i = 0; i < kBoundaries / 2; ++i)
+	{
+		iMap.insert(4 * i, 4 * i + 2, i % 7 + 1);
+	}
+
+	std::size_t calls = 0;
+	std::vector<std::pair<int, int>> ranges;
+	unsigned seed = 42;
+	auto next = [&seed](int range) { seed = seed * 1103515245u + 12345u; return static_cast<int>((seed >> 8) % range); };
+	for (int i = 0; i < kTransforms; ++i)
+	{
+		const int keyBegin = next(3 * kBoundaries);
+		ranges.emplace_back(keyBegin, keyBegin + kBoundaries / 2);
+		iMap.transform(keyBegin, keyBegin + kBoundaries / 2, [&calls](int val) { ++calls; return val + 1; });
+	}
+	EXPECT_EQ(calls, 0);
+	EXPECT_EQ(iMap.pendingCount(), kTransforms);
+
+	const int key = 3 * kBoundaries / 2 + 1;
+	const auto covering = std::count_if(ranges.begin(), ranges.end(), [key](const auto& range) { return range.first <= key && key < range.second; });
+	const int val = iMap[key];
+	EXPECT_EQ(calls, static_cast<std::size_t>(covering));
+	EXPECT_EQ(iMap[key], val);
+	EXPECT_EQ(calls, static_cast<std::size_t>(covering));
+
+	// Materializing pays once per covered boundary, what an eager rewrite pays up front
+	const auto& materialized = iMap.materialize();
+	EXPECT_GT(calls, std::size_t(kTransforms) * 1000);
+	EXPECT_EQ(iMap.pendingCount(), 0);
+	EXPECT_EQ(materialized[key], val);
+	for (int k = 0; k < 4 * kBoundaries; k += 13)
+	{
+		ASSERT_EQ(iMap[k], materialized[k]);
+	}
+}
@@ -0,0 +1,89 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "IntervalMapTest.hpp"
+#include "PersistentIntervalMap.hpp"
+
+namespace
+{
+	template <typename K, typename V>
+	std::vector<std::pair<K, V>> boundariesOf(const DS::PersistentIntervalMap<K, V>& iMap)
+	{
+		std::vector<std::pair<K, V>> result;
+		iMap.forEachBoundary([&result](const K& key, const V& val) { result.emplace_back(key, val); });
+		return result;
+	}
+
+	template <typename K, typename V>
+	std::vector<std::pair<K, V>> boundariesOf(const DS::IntervalMap<K, V>& iMap)
+	{
+		return { iMap.getMap().begin(), iMap.getMap().end() };
+	}
+}
+
+TEST(PersistentIntervalMapTest, BasicInsertion)
+{
+	DS::PersistentIntervalMap<int, std::string> iMap("Default");
+
+	iMap.insert(2, 8, "Custom");
+	iMap.insert(5, 10, "Other");
+
+	EXPECT_EQ(iMap[1], "Default");
+	EXPECT_EQ(iMap[2], "Custom");
+	EXPECT_EQ(iMap[4], "Custom");
+	EXPECT_EQ(iMap[5], "Other");
+	EXPECT_EQ(iMap[9], "Other");
+	EXPECT_EQ(iMap[10], "Default");
+	EXPECT_EQ(iMap.size(), 3);
+}
+
+// Same canonical boundaries as the mutable map after any sequence of insertions
+TEST(PersistentIntervalMapTest, MatchesIntervalMap)
+{
+	DS::IntervalMap<int, int> expected(0);
+	DS::PersistentIntervalMap<int, int> iMap(0);
+
+	for (const auto& interval : makeRandomIntervals(3000, 2000, 80, 4))
+	{
+		expected.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		iMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+	}
+
+	EXPECT_EQ(boundariesOf(iMap), boundariesOf(expected));
+	for (int key = -1; key < 2100; ++key)
+	{
+		ASSERT_EQ(iMap[key], expected[key]) << "key " << key;
+	}
+}
+
+// Every snapshot keeps answering with the state it was taken in
+TEST(PersistentIntervalMapTest, SnapshotsAreIndependent)
+{
+	DS::IntervalMap<int, int> expected(0);
+	DS::PersistentIntervalMap<int, int> iMap(0);
+
+	std::vector<DS::PersistentIntervalMap<int, int>> versions;
+	std::vector<std::vector<std::pair<int, int>>> expectedVersions;
+
+	for (const auto& interval : makeRandomIntervals(500, 1000, 100, 5, 3))
+	{
+		versions.push_back(iMap.snapshot());
+		expectedVersions.push_back(boundariesOf(expected));
+
+		expected.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		iMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+	}
+
+	for (size_t i = 0; i < versions.size(); ++i)
+	{
+		ASSERT_EQ(boundariesOf(versions[i]), expectedVersions[i]) << "version " << i;
+	}
+
+	// Inserting into an old snapshot forks it without touching the others
+	auto fork = versions[100];
+	fork.insert(0, 1000, 7);
+	EXPECT_EQ(fork[500], 7);
+	EXPECT_EQ(boundariesOf(versions[100]), expectedVersions[100]);
+}
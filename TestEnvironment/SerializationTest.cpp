@@ -0,0 +1,113 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "BinaryFormat.hpp"
+#include "IntervalMapTest.hpp"
+#include "MappedIntervalMap.hpp"
+
+TYPED_TEST(IntervalMapStorageTest, MappedMatchesMap)
+{
+	DS::IntervalMap<int, int, TypeParam> iMap(-1);
+	for (const auto& interval : makeRandomIntervals(5000, 10000, 100, 16))
+	{
+		iMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+	}
+
+	TempPath path("interval_map_mapped_view.bin");
+	DS::saveBinary(iMap, path.str());
+
+	const DS::MappedIntervalMap<int, int> view(path.str());
+	ASSERT_EQ(view.size(), iMap.getMap().size());
+	EXPECT_EQ(view.valBegin(), -1);
+	for (int key = -10; key < 10200; ++key)
+	{
+		ASSERT_EQ(view[key], iMap[key]) << "key " << key;
+	}
+
+	std::vector<int> keys(1000);
+	std::vector<int> out(keys.size());
+	for (std::size_t i = 0; i < keys.size(); ++i)
+	{
+		keys[i] = static_cast<int>((i * 7919) % 10100);
+	}
+	view.lookupBatch(keys.data(), keys.size(), out.data());
+	for (std::size_t i = 0; i < keys.size(); ++i)
+	{
+		ASSERT_EQ(out[i], iMap[keys[i]]);
+	}
+
+	expectSameBoundaries(view.template toIntervalMap<TypeParam>(), iMap);
+}
+
+TEST(SerializationTest, EmptyMapRoundTrip)
+{
+	DS::IntervalMap<int, double> iMap(2.5);
+
+	TempPath path("interval_map_empty.bin");
+	DS::saveBinary(iMap, path.str());
+
+	const DS::MappedIntervalMap<int, double> view(path.str());
+	EXPECT_TRUE(view.empty());
+	EXPECT_EQ(view[0], 2.5);
+	EXPECT_TRUE(view.toIntervalMap().getMap().empty());
+}
+
+// Arrays start at aligned offsets and the header fields are little-endian whatever the host is
+TEST(SerializationTest, LayoutIsStable)
+{
+	DS::IntervalMap<std::int64_t, float> iMap(0.0f);
+	iMap.insert(1, 5, 1.5f);
+
+	std::ostringstream out;
+	DS::writeBinary(iMap, out);
+	const std::string bytes = out.str();
+
+	const auto header = DS::binary::readHeader<std::int64_t, float>(reinterpret_cast<const std::byte*>(bytes.data()), bytes.size());
+	EXPECT_EQ(header.count, 2);
+	EXPECT_EQ(header.keysOffset % DS::binary::kArrayAlignment, 0);
+	EXPECT_EQ(header.valuesOffset % DS::binary::kArrayAlignment, 0);
+	EXPECT_EQ(bytes.size(), header.valuesOffset + 2 * sizeof(float));
+	EXPECT_EQ(static_cast<unsigned char>(bytes[8]), DS::binary::kVersion);
+}
+
+TEST(SerializationTest, RejectsMismatchingFiles)
+{
+	DS::IntervalMap<int, int> iMap(0);
+	iMap.insert(1, 5, 7);
+
+	TempPath path("interval_map_mismatch.bin");
+	DS::saveBinary(iMap, path.str());
+	EXPECT_THROW((DS::MappedIntervalMap<std::int64_t, int>(path.str())), std::runtime_error);
+
+	TempPath garbage("interval_map_garbage.bin");
+	std::ofstream(garbage.str(), std::ios::binary) << "not an interval map, not at all";
+	EXPECT_THROW((DS::MappedIntervalMap<int, int>(garbage.str())), std::runtime_error);
+
+	// Aligned offsets so large that adding a size wraps around
+	std::string valid;
+	{
+		std::ifstream in(path.str(), std::ios::binary);
+		valid.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+	for (const std::size_t field : { offsetof(DS::binary::Header, valBeginOffset), offsetof(DS::binary::Header, keysOffset), offsetof(DS::binary::Header, valuesOffset) })
+	{
+		std::string patched = valid;
+		const std::uint64_t offset = DS::binary::toLittle(std::numeric_limits<std::uint64_t>::max() - 3);
+		std::memcpy(patched.data() + field, &offset, sizeof(offset));
+
+		TempPath corrupted("interval_map_corrupted.bin");
+		std::ofstream(corrupted.str(), std::ios::binary) << patched;
+		EXPECT_THROW((DS::MappedIntervalMap<int, int>(corrupted.str())), std::runtime_error) << "field at " << field;
+	}
+
+	EXPECT_THROW((DS::MappedIntervalMap<int, int>(path.str() + ".missing")), std::runtime_error);
+}
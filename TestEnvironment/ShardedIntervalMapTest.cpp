@@ -0,0 +1,94 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "IntervalMapTest.hpp"
+#include "ShardedIntervalMap.hpp"
+
+TEST(ShardedIntervalMapTest, InsertionAcrossShards)
+{
+	DS::ShardedIntervalMap<int, std::string> iMap({ 10, 20, 30 }, "Default");
+	ASSERT_EQ(iMap.shardCount(), 4);
+
+	iMap.insert(5, 25, "Wide");
+	iMap.insert(20, 30, "Exact");
+
+	EXPECT_EQ(iMap[4], "Default");
+	EXPECT_EQ(iMap[5], "Wide");
+	EXPECT_EQ(iMap[10], "Wide");
+	EXPECT_EQ(iMap[19], "Wide");
+	EXPECT_EQ(iMap[20], "Exact");
+	EXPECT_EQ(iMap[29], "Exact");
+	EXPECT_EQ(iMap[30], "Default");
+
+	// No boundary left at the shard edge 10, which both shards hold
+	const auto merged = iMap.snapshot();
+	using Boundaries = std::vector<std::pair<int, std::string>>;
+	const Boundaries expected = { { 5, "Wide" }, { 20, "Exact" }, { 30, "Default" } };
+	EXPECT_EQ(Boundaries(merged.getMap().begin(), merged.getMap().end()), expected);
+}
+
+TEST(ShardedIntervalMapTest, MatchesIntervalMap)
+{
+	DS::IntervalMap<int, int> expected(0);
+	DS::ShardedIntervalMap<int, int> iMap({ 100, 250, 251, 600, 1000 }, 0);
+
+	for (const auto& interval : makeRandomIntervals(3000, 1200, 200, 4))
+	{
+		expected.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		iMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+	}
+
+	for (int key = -1; key < 1500; ++key)
+	{
+		ASSERT_EQ(iMap[key], expected[key]) << "key " << key;
+	}
+	expectSameBoundaries(iMap.snapshot(), expected);
+}
+
+// Writers own disjoint key ranges which cut through shard edges, so the result does not depend on scheduling
+TEST(ShardedIntervalMapTest, ParallelWriters)
+{
+	constexpr int kThreads = 8;
+	constexpr int kRange = 1000;
+
+	std::vector<int> splitKeys;
+	for (int key = 300; key < kThreads * kRange; key += 700)
+	{
+		splitKeys.push_back(key);
+	}
+	DS::ShardedIntervalMap<int, int> iMap(splitKeys, 0);
+	DS::IntervalMap<int, int> expected(0);
+
+	std::vector<std::vector<DS::Interval<int, int>>> work(kThreads);
+	for (int t = 0; t < kThreads; ++t)
+	{
+		for (auto interval : makeRandomIntervals(2000, kRange - 100, 100, 5, t + 1))
+		{
+			interval.keyBegin += t * kRange;
+			interval.keyEnd += t * kRange;
+			work[t].push_back(interval);
+			expected.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		}
+	}
+
+	std::vector<std::thread> writers;
+	for (int t = 0; t < kThreads; ++t)
+	{
+		writers.emplace_back([&, t]
+		{
+			for (const auto& interval : work[t])
+			{
+				iMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+			}
+		});
+	}
+	for (auto& writer : writers)
+	{
+		writer.join();
+	}
+
+	expectSameBoundaries(iMap.snapshot(), expected);
+}
@@ -0,0 +1,57 @@
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "IntervalMapTest.hpp"
+
+TEST(SmallIntervalMapTest, NoAllocationUpToCapacity)
+{
+	// Any allocation throws
+	std::pmr::polymorphic_allocator<std::pair<const int, int>> alloc(std::pmr::null_memory_resource());
+	DS::pmr::IntervalMap<int, int, DS::SmallStorage<8>> iMap(0, alloc);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		iMap.insert(10 * i, 10 * i + 5, i + 1);
+	}
+	iMap.insert(12, 14, 7);
+	EXPECT_EQ(iMap.getMap().size(), 8);
+	EXPECT_EQ(iMap[13], 7);
+	EXPECT_EQ(iMap[14], 2);
+	EXPECT_EQ(iMap[25], 0);
+
+	EXPECT_THROW(iMap.insert(100, 105, 1), std::bad_alloc);
+}
+
+TEST(SmallIntervalMapTest, SpillsPastCapacity)
+{
+	DS::IntervalMap<int, std::string> expected("Default");
+	DS::SmallIntervalMap<int, std::string, 8> iMap("Default");
+
+	const auto intervals = makeRandomIntervals(500, 300, 40, 5);
+	for (size_t i = 0; i < intervals.size(); ++i)
+	{
+		const auto& interval = intervals[i];
+		expected.insert(interval.keyBegin, interval.keyEnd, std::to_string(interval.val));
+		iMap.insert(interval.keyBegin, interval.keyEnd, std::to_string(interval.val));
+
+		// Copies and moves of both inline and spilled arrays
+		if (i % 50 == 0)
+		{
+			auto copy = iMap;
+			iMap = std::move(copy);
+			expectSameBoundaries(iMap, expected);
+		}
+	}
+	expectSameBoundaries(iMap, expected);
+
+	// Shrinking back under the capacity keeps working on the heap arrays
+	iMap.insert(-10, 400, "Default");
+	iMap.insert(5, 10, "Small");
+	EXPECT_EQ(iMap.getMap().size(), 2);
+	EXPECT_EQ(iMap[5], "Small");
+	EXPECT_EQ(iMap[10], "Default");
+}
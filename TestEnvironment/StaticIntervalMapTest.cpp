@@ -0,0 +1,47 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "IntervalMapTest.hpp"
+#include "StaticIntervalMap.hpp"
+
+TEST(StaticIntervalMapTest, EmptyMapAnswersValBegin)
+{
+	const DS::IntervalMap<int, std::string> iMap("Default");
+	const auto frozen = DS::freeze(iMap);
+
+	EXPECT_TRUE(frozen.empty());
+	EXPECT_EQ(frozen[-5], "Default");
+	EXPECT_EQ(frozen[0], "Default");
+}
+
+// Every tree shape: sizes around powers of two leave the last Eytzinger level full, partial or empty
+TYPED_TEST(IntervalMapStorageTest, StaticMatchesIntervalMap)
+{
+	for (size_t count : { 1, 2, 3, 7, 8, 9, 31, 100, 1000, 5000 })
+	{
+		DS::IntervalMap<int, int, TypeParam> iMap(0);
+		for (const auto& interval : makeRandomIntervals(count, static_cast<int>(count) * 4, 20, 6, static_cast<unsigned>(count)))
+		{
+			iMap.insert(interval.keyBegin, interval.keyEnd, interval.val);
+		}
+
+		const auto frozen = DS::freeze(iMap);
+		ASSERT_EQ(frozen.size(), iMap.getMap().size());
+
+		std::vector<int> keys;
+		for (int key = -3; key < static_cast<int>(count) * 4 + 25; ++key)
+		{
+			ASSERT_EQ(frozen[key], iMap[key]) << "count " << count << ", key " << key;
+			keys.push_back(key);
+		}
+
+		std::vector<int> out(keys.size());
+		frozen.lookupBatch(keys.data(), keys.size(), out.data());
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			ASSERT_EQ(out[i], iMap[keys[i]]);
+		}
+	}
+}
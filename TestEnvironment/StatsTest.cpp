@@ -0,0 +1,99 @@
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "IntervalMapTest.hpp"
+
+namespace
+{
+	// Every operation is timed
+	template <typename Storage>
+	using CountedMap = DS::IntervalMap<int, int, Storage, std::allocator<std::pair<const int, int>>, DS::CountingStats<0>>;
+
+	std::uint64_t samples(const DS::LatencyHistogram& histogram)
+	{
+		return std::accumulate(histogram.begin(), histogram.end(), std::uint64_t(0));
+	}
+}
+
+// Without stats the policy costs no space: next to valBegin and the boundaries there are only the version and the journal link.
+// Only asserted on the Itanium ABI, where the layout of empty [[no_unique_address]] members is specified.
+#if !defined(_MSC_VER)
+static_assert(sizeof(DS::IntervalMap<std::int64_t, std::int64_t>) == sizeof(std::int64_t) + sizeof(std::uint64_t) + sizeof(void*) + sizeof(std::map<std::int64_t, std::int64_t>));
+#endif
+
+TYPED_TEST(IntervalMapStorageTest, StatsCountsOperationsAndBoundaries)
+{
+	CountedMap<TypeParam> iMap(0);
+
+	iMap.insert(10, 20, 1);	// Creates 10 and 20
+	iMap.insert(12, 14, 1);	// Changes nothing
+	iMap.insert(15, 30, 2);	// Creates 15, moves 20 to 30
+	iMap.insert(5, 40, 0);	// Erases all three
+	iMap.insert(7, 7, 3);	// Empty, still an insert call
+	for (int key = 0; key < 5; ++key)
+	{
+		EXPECT_EQ(iMap[key], 0);
+	}
+
+	const DS::StatsSnapshot snapshot = iMap.statsSnapshot();
+	EXPECT_EQ(snapshot.inserts, 5);
+	EXPECT_EQ(snapshot.lookups, 5);
+	EXPECT_EQ(snapshot.boundariesCreated, 4);
+	EXPECT_EQ(snapshot.boundariesErased, 4);
+	EXPECT_EQ(snapshot.boundaries, 0);
+	EXPECT_EQ(samples(snapshot.insertLatency), 5);
+	EXPECT_EQ(samples(snapshot.lookupLatency), 5);
+
+	// Statistics describe one object, a copy starts from zero
+	const auto copy = iMap;
+	EXPECT_EQ(copy.statsSnapshot().inserts, 0);
+}
+
+// Flat storages rebuild the map for batches, trees insert the segments: both count intervals and boundaries
+TYPED_TEST(IntervalMapStorageTest, StatsCountsBatches)
+{
+	CountedMap<TypeParam> iMap(0);
+
+	const std::vector<DS::Interval<int, int>> disjoint = { { 0, 10, 1 }, { 20, 30, 2 }, { 40, 50, 3 } };
+	iMap.insertBatch(disjoint);
+	DS::StatsSnapshot snapshot = iMap.statsSnapshot();
+	EXPECT_EQ(snapshot.inserts, 3);
+	EXPECT_EQ(snapshot.boundariesCreated, 6);
+	EXPECT_EQ(snapshot.boundariesErased, 0);
+
+	const std::vector<DS::Interval<int, int>> cover = { { 0, 25, 0 }, { 25, 50, 0 } };
+	iMap.insertBatch(cover);
+	snapshot = iMap.statsSnapshot();
+	EXPECT_EQ(snapshot.inserts, 5);
+	EXPECT_EQ(snapshot.boundaries, 0);
+	EXPECT_EQ(snapshot.boundariesErased, snapshot.boundariesCreated); // Exact counts differ between the paths, the net change does not
+}
+
+TEST(StatsTest, SamplesAndExports)
+{
+	DS::IntervalMap<int, int, DS::TreeStorage, std::allocator<std::pair<const int, int>>, DS::CountingStats<4>> iMap(0);
+	for (int i = 0; i < 100; ++i)
+	{
+		iMap.insert(2 * i, 2 * i + 1, 1);
+	}
+
+	const DS::StatsSnapshot snapshot = iMap.statsSnapshot();
+	EXPECT_EQ(snapshot.inserts, 100);
+	EXPECT_EQ(samples(snapshot.insertLatency), 7); // Inserts 0, 16, ..., 96
+	EXPECT_EQ(snapshot.boundaries, 200);
+	EXPECT_GT(snapshot.bytes, 200 * 2 * sizeof(int));
+	EXPECT_GT(DS::latencyQuantile(snapshot.insertLatency, 0.5), 0);
+	EXPECT_EQ(DS::latencyQuantile(snapshot.lookupLatency, 0.5), 0);
+
+	std::map<std::string, double> exported;
+	snapshot.exportTo([&exported](const std::string& name, double value) { exported[name] = value; });
+	EXPECT_EQ(exported.at("inserts_total"), 100);
+	EXPECT_EQ(exported.at("boundaries_created_total"), 200);
+	EXPECT_EQ(exported.at("boundaries"), 200);
+	EXPECT_TRUE(exported.count("insert_latency_p99_ns"));
+}
@@ -1,3 +1,5 @@
+#include <iostream>
+
 #include <gtest/gtest.h>
 
 int main(int argc, char** argv)
@@ -5,7 +7,9 @@ int main(int argc, char** argv)
 	::testing::InitGoogleTest(&argc, argv);
 	int result = RUN_ALL_TESTS();
 
+	// Keeps the console of IDE runs open. Test drivers such as ctest define INTERVAL_MAP_NO_PAUSE.
+#ifndef INTERVAL_MAP_NO_PAUSE
 	std::cin.get();
+#endif
 	return result;
 }
-
@@ -0,0 +1,61 @@
+# interval_map_optimize(<target>) applies the optimization options of the root project to an executable.
+#
+# PGO workflow (GCC or Clang):
+#   cmake -B build-gen -DINTERVAL_MAP_PGO=GENERATE && cmake --build build-gen --target pgo_train
+#   (Clang only) llvm-profdata merge -o <INTERVAL_MAP_PGO_DIR>/default.profdata <INTERVAL_MAP_PGO_DIR>/*.profraw
+#   cmake -B build-use -DINTERVAL_MAP_PGO=USE -DINTERVAL_MAP_PGO_DIR=<same dir> && cmake --build build-use
+
+include(CheckIPOSupported)
+
+if (INTERVAL_MAP_LTO)
+	check_ipo_supported(RESULT INTERVAL_MAP_IPO_SUPPORTED OUTPUT INTERVAL_MAP_IPO_ERROR LANGUAGES CXX)
+	if (NOT INTERVAL_MAP_IPO_SUPPORTED)
+		message(WARNING "INTERVAL_MAP_LTO: not supported by this toolchain: ${INTERVAL_MAP_IPO_ERROR}")
+	endif()
+endif()
+
+if (NOT INTERVAL_MAP_PGO MATCHES "^(OFF|GENERATE|USE)$")
+	message(FATAL_ERROR "INTERVAL_MAP_PGO must be OFF, GENERATE or USE, got '${INTERVAL_MAP_PGO}'")
+endif()
+if (NOT INTERVAL_MAP_PGO STREQUAL "OFF" AND NOT CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang")
+	message(WARNING "INTERVAL_MAP_PGO is only wired for GCC and Clang, ignored for ${CMAKE_CXX_COMPILER_ID}")
+endif()
+
+function(interval_map_optimize target)
+	if (MSVC)
+		target_compile_options(${target} PRIVATE $<$<CONFIG:Release,RelWithDebInfo>:/O2>)
+		if (INTERVAL_MAP_NATIVE)
+			target_compile_options(${target} PRIVATE /arch:AVX2)
+		endif()
+	else()
+		target_compile_options(${target} PRIVATE $<$<CONFIG:Release,RelWithDebInfo>:-O3>)
+		if (INTERVAL_MAP_NATIVE)
+			target_compile_options(${target} PRIVATE -march=native)
+		endif()
+	endif()
+
+	if (INTERVAL_MAP_LTO AND INTERVAL_MAP_IPO_SUPPORTED)
+		set_property(TARGET ${target} PROPERTY INTERPROCEDURAL_OPTIMIZATION TRUE)
+	endif()
+
+	if (CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang")
+		# GCC names profiles after object paths, this keeps them valid for a different build directory
+		if (CMAKE_CXX_COMPILER_ID STREQUAL "GNU" AND NOT INTERVAL_MAP_PGO STREQUAL "OFF")
+			target_compile_options(${target} PRIVATE -fprofile-prefix-path=${CMAKE_BINARY_DIR})
+		endif()
+
+		if (INTERVAL_MAP_PGO STREQUAL "GENERATE")
+			target_compile_options(${target} PRIVATE -fprofile-generate=${INTERVAL_MAP_PGO_DIR})
+			target_link_options(${target} PRIVATE -fprofile-generate=${INTERVAL_MAP_PGO_DIR})
+		elseif (INTERVAL_MAP_PGO STREQUAL "USE")
+			if (CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+				set(profile ${INTERVAL_MAP_PGO_DIR})
+				target_compile_options(${target} PRIVATE -fprofile-partial-training)
+			else()
+				set(profile ${INTERVAL_MAP_PGO_DIR}/default.profdata)
+			endif()
+			target_compile_options(${target} PRIVATE -fprofile-use=${profile})
+			target_link_options(${target} PRIVATE -fprofile-use=${profile})
+		endif()
+	endif()
+endfunction()